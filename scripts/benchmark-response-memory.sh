@@ -0,0 +1,60 @@
+#!/bin/bash
+
+# Peak memory benchmark for /ddb/run responses
+
+# Usage: ./benchmark-response-memory.sh <duckdb> [row_count] [port]
+# <duckdb>              : DuckDB CLI built with this extension (e.g. build/release/duckdb)
+# [row_count]           : Number of rows in the result (default: 10000000)
+# [port]                : Port of the UI server (default: 4999)
+#
+# Starts the UI server, runs a query with a large result through /ddb/run, and
+# prints the peak resident set size (VmHWM) of the DuckDB process before and
+# after the request. Run it against builds from before and after a change to
+# compare them. Linux only.
+
+set -e
+
+duckdb=$1
+row_count=${2:-10000000}
+port=${3:-4999}
+url="http://localhost:$port"
+
+if [[ -z $duckdb ]]; then
+  echo "Usage: $0 <duckdb> [row_count] [port]"
+  exit 1
+fi
+
+# The CLI exits at the end of its input, so keep its input open until the
+# benchmark is done.
+fifo=$(mktemp -u)
+mkfifo $fifo
+exec 3<>$fifo
+rm $fifo
+
+ui_local_port=$port $duckdb <&3 >/dev/null &
+pid=$!
+trap "kill $pid 2>/dev/null" EXIT
+echo "CALL start_ui_server();" >&3
+
+for _ in $(seq 100); do
+  if curl -s -o /dev/null "$url/info"; then
+    break
+  fi
+  sleep 0.1
+done
+
+peak_rss() {
+  awk '/VmHWM/ { print $2 " kB" }' /proc/$pid/status
+}
+
+echo "Peak RSS after start:   $(peak_rss)"
+
+# Ask for an uncompressed response, so only the serialization is measured.
+curl -s -o /dev/null -X POST \
+  -H "Origin: $url" \
+  -H "Accept-Encoding: identity" \
+  -w "Response:               %{size_download} bytes in %{time_total} s\n" \
+  --data "SELECT i, i::VARCHAR AS s, i / 3 AS d FROM range($row_count) t(i)" \
+  "$url/ddb/run"
+
+echo "Peak RSS after request: $(peak_rss)"
@@ -0,0 +1,248 @@
+#include "asset_bundle.hpp"
+
+#define CPPHTTPLIB_OPENSSL_SUPPORT
+#include "httplib.hpp"
+
+#include <cstring>
+
+#ifdef _WIN32
+#include <duckdb/common/windows_util.hpp>
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace httplib = duckdb_httplib_openssl;
+
+#define TAR_BLOCK_SIZE 512
+
+namespace duckdb {
+namespace ui {
+
+static void MapFile(const std::string &path, const char *&data,
+                    idx_t &size_bytes) {
+#ifdef _WIN32
+  auto file = CreateFileW(WindowsUtil::UTF8ToUnicode(path.c_str()).c_str(),
+                          GENERIC_READ, FILE_SHARE_READ, nullptr,
+                          OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    throw IOException("Could not open asset bundle \"%s\"", path);
+  }
+  LARGE_INTEGER file_size;
+  if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0) {
+    CloseHandle(file);
+    throw IOException("Asset bundle \"%s\" is empty", path);
+  }
+  auto mapping =
+      CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  // The view keeps the file mapped once the handles are closed.
+  auto view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0)
+                      : nullptr;
+  if (mapping) {
+    CloseHandle(mapping);
+  }
+  CloseHandle(file);
+  if (!view) {
+    throw IOException("Could not map asset bundle \"%s\"", path);
+  }
+  data = static_cast<const char *>(view);
+  size_bytes = static_cast<idx_t>(file_size.QuadPart);
+#else
+  auto fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw IOException("Could not open asset bundle \"%s\": %s", path,
+                      strerror(errno));
+  }
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0 || file_stat.st_size == 0) {
+    close(fd);
+    throw IOException("Asset bundle \"%s\" is empty", path);
+  }
+  // The mapping stays valid once the file is closed.
+  auto view = mmap(nullptr, static_cast<size_t>(file_stat.st_size), PROT_READ,
+                   MAP_SHARED, fd, 0);
+  close(fd);
+  if (view == MAP_FAILED) {
+    throw IOException("Could not map asset bundle \"%s\": %s", path,
+                      strerror(errno));
+  }
+  data = static_cast<const char *>(view);
+  size_bytes = static_cast<idx_t>(file_stat.st_size);
+#endif
+}
+
+static void UnmapFile(const char *data, idx_t size_bytes) {
+#ifdef _WIN32
+  UnmapViewOfFile(data);
+#else
+  munmap(const_cast<char *>(data), static_cast<size_t>(size_bytes));
+#endif
+}
+
+// Reads a NUL-terminated (or full-length) text field of a tar header.
+static std::string ReadField(const char *field, idx_t length) {
+  return std::string(field, strnlen(field, length));
+}
+
+// Reads a numeric field of a tar header: octal digits, or a big-endian binary
+// number if the high bit of the first byte is set (for large files).
+static idx_t ReadNumber(const char *field, idx_t length) {
+  idx_t value = 0;
+  if (static_cast<unsigned char>(field[0]) & 0x80) {
+    for (idx_t i = 1; i < length; i++) {
+      value = (value << 8) | static_cast<unsigned char>(field[i]);
+    }
+    return value;
+  }
+  for (idx_t i = 0; i < length; i++) {
+    auto c = field[i];
+    if (c >= '0' && c <= '7') {
+      value = (value << 3) | static_cast<idx_t>(c - '0');
+    } else if (c != ' ' || value != 0) {
+      break;
+    }
+  }
+  return value;
+}
+
+// Returns the path in a pax extended header ("<length> path=<value>\n"
+// records), or an empty string.
+static std::string ReadPaxPath(const char *records, idx_t length) {
+  idx_t offset = 0;
+  while (offset < length) {
+    auto space = static_cast<const char *>(
+        memchr(records + offset, ' ', length - offset));
+    if (!space) {
+      break;
+    }
+    auto record_length = std::strtoull(records + offset, nullptr, 10);
+    auto key_offset = static_cast<idx_t>(space - records) + 1;
+    auto record_end = offset + record_length;
+    if (record_length == 0 || record_end > length || key_offset >= record_end) {
+      break;
+    }
+    // Drops the trailing newline.
+    std::string record(records + key_offset, record_end - key_offset - 1);
+    if (StringUtil::StartsWith(record, "path=")) {
+      return record.substr(5);
+    }
+    offset = record_end;
+  }
+  return std::string();
+}
+
+// Paths in archives are relative, and often start with "./".
+static std::string NormalizePath(std::string path) {
+  while (StringUtil::StartsWith(path, "./")) {
+    path = path.substr(2);
+  }
+  while (StringUtil::StartsWith(path, "/")) {
+    path = path.substr(1);
+  }
+  return path;
+}
+
+AssetBundle::AssetBundle(const std::string &path) {
+  MapFile(path, data, size_bytes);
+  try {
+    Index();
+  } catch (...) {
+    UnmapFile(data, size_bytes);
+    throw;
+  }
+}
+
+AssetBundle::~AssetBundle() { UnmapFile(data, size_bytes); }
+
+const std::string &AssetBundle::GetVersion() const { return version; }
+
+idx_t AssetBundle::GetAssetCount() const { return files.size(); }
+
+idx_t AssetBundle::GetSizeBytes() const { return size_bytes; }
+
+bool AssetBundle::Find(const std::string &path, Asset &asset) const {
+  auto file_path = NormalizePath(path);
+  if (file_path.empty() || StringUtil::EndsWith(file_path, "/")) {
+    file_path += "index.html";
+  }
+  auto it = files.find(file_path);
+  if (it == files.end()) {
+    file_path += "/index.html";
+    it = files.find(file_path);
+    if (it == files.end()) {
+      return false;
+    }
+  }
+  asset.data = data + it->second.first;
+  asset.size = it->second.second;
+  asset.content_type = httplib::detail::find_content_type(
+      file_path, {}, "application/octet-stream");
+  return true;
+}
+
+void AssetBundle::Index() {
+  // Set by GNU long name and pax headers, for the entry that follows them.
+  std::string next_path;
+  idx_t offset = 0;
+  while (offset + TAR_BLOCK_SIZE <= size_bytes) {
+    auto header = data + offset;
+    // The archive ends with zero blocks.
+    if (header[0] == '\0') {
+      break;
+    }
+    if (memcmp(header + 257, "ustar", 5) != 0) {
+      throw IOException("Asset bundle is not a tar archive");
+    }
+    auto entry_size = ReadNumber(header + 124, 12);
+    auto entry_offset = offset + TAR_BLOCK_SIZE;
+    if (entry_size > size_bytes - entry_offset) {
+      throw IOException("Asset bundle is truncated");
+    }
+
+    auto type = header[156];
+    switch (type) {
+    case 'L':
+      next_path = ReadField(data + entry_offset, entry_size);
+      break;
+    case 'x':
+      next_path = ReadPaxPath(data + entry_offset, entry_size);
+      break;
+    case '0':
+    case '\0': {
+      auto path = next_path;
+      if (path.empty()) {
+        auto prefix = ReadField(header + 345, 155);
+        path = ReadField(header, 100);
+        if (!prefix.empty()) {
+          path = prefix + "/" + path;
+        }
+      }
+      files[NormalizePath(path)] = std::make_pair(entry_offset, entry_size);
+      next_path.clear();
+      break;
+    }
+    default:
+      // Directories, links, and the like.
+      next_path.clear();
+      break;
+    }
+
+    offset = entry_offset + (entry_size + TAR_BLOCK_SIZE - 1) /
+                                TAR_BLOCK_SIZE * TAR_BLOCK_SIZE;
+  }
+
+  if (files.empty()) {
+    throw IOException("Asset bundle holds no files");
+  }
+  auto it = files.find("VERSION");
+  if (it != files.end()) {
+    version = std::string(data + it->second.first, it->second.second);
+    StringUtil::Trim(version);
+  }
+}
+
+} // namespace ui
+} // namespace duckdb
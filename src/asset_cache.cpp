@@ -0,0 +1,249 @@
+#include "asset_cache.hpp"
+
+#include "utils/serialization.hpp"
+
+#include <duckdb/common/serializer/binary_deserializer.hpp>
+#include <duckdb/common/serializer/binary_serializer.hpp>
+#include <duckdb/common/serializer/memory_stream.hpp>
+
+#include <openssl/sha.h>
+
+#include <algorithm>
+#include <utility>
+
+#define ASSET_FILE_SUFFIX ".asset"
+// Entries are written to a temporary file first, then renamed, so a crash
+// can't leave a truncated entry behind.
+#define TEMP_FILE_SUFFIX ".tmp"
+
+namespace duckdb {
+namespace ui {
+
+std::string CachedAsset::GetHeader(const std::string &name) const {
+  for (idx_t i = 0; i < header_names.size(); i++) {
+    if (StringUtil::CIEquals(header_names[i], name)) {
+      return header_values[i];
+    }
+  }
+  return std::string();
+}
+
+void CachedAsset::Serialize(Serializer &serializer) const {
+  serializer.WriteProperty(100, "key", key);
+  serializer.WriteProperty(101, "status", status);
+  serializer.WriteProperty(102, "header_names", header_names);
+  serializer.WriteProperty(103, "header_values", header_values);
+  serializer.WriteProperty(104, "body", body);
+}
+
+unique_ptr<CachedAsset> CachedAsset::Deserialize(Deserializer &deserializer) {
+  auto result = make_uniq<CachedAsset>();
+  deserializer.ReadProperty(100, "key", result->key);
+  deserializer.ReadProperty(101, "status", result->status);
+  deserializer.ReadProperty(102, "header_names", result->header_names);
+  deserializer.ReadProperty(103, "header_values", result->header_values);
+  deserializer.ReadProperty(104, "body", result->body);
+  return result;
+}
+
+// Keys hold URLs, which can't be used as file names as is.
+static std::string GetFileName(const std::string &key) {
+  unsigned char digest[SHA256_DIGEST_LENGTH];
+  SHA256(reinterpret_cast<const unsigned char *>(key.data()), key.size(),
+         digest);
+  static const char *hex_digits = "0123456789abcdef";
+  std::string file_name;
+  for (auto byte : digest) {
+    file_name += hex_digits[byte >> 4];
+    file_name += hex_digits[byte & 0xf];
+  }
+  return file_name + ASSET_FILE_SUFFIX;
+}
+
+AssetCache::AssetCache(std::string _directory, idx_t _capacity_bytes)
+    : fs(FileSystem::CreateLocal()), directory(std::move(_directory)),
+      capacity_bytes(_capacity_bytes) {
+  try {
+    if (!fs->DirectoryExists(directory)) {
+      fs->CreateDirectory(directory);
+    }
+    Load();
+  } catch (std::exception &) {
+    // Writing entries will fail as well, so the cache stays empty.
+  }
+}
+
+std::string AssetCache::MakeKey(const std::string &remote_url,
+                                const std::string &path,
+                                const std::string &query) {
+  return query.empty() ? remote_url + path : remote_url + path + "?" + query;
+}
+
+unique_ptr<CachedAsset> AssetCache::Get(const std::string &key) {
+  auto file_name = GetFileName(key);
+  {
+    std::lock_guard<std::mutex> guard(mutex);
+    auto it = entries_by_file_name.find(file_name);
+    if (it == entries_by_file_name.end()) {
+      return nullptr;
+    }
+    entries.splice(entries.begin(), entries, it->second);
+  }
+
+  try {
+    auto handle = fs->OpenFile(GetPath(file_name),
+                               FileFlags::FILE_FLAGS_READ |
+                                   FileFlags::FILE_FLAGS_NULL_IF_NOT_EXISTS);
+    if (handle) {
+      auto size = static_cast<idx_t>(handle->GetFileSize());
+      std::string bytes(size, '\0');
+      handle->Read(const_cast<char *>(bytes.data()), size, 0);
+      MemoryStream stream(
+          reinterpret_cast<data_ptr_t>(const_cast<char *>(bytes.data())),
+          size);
+      auto asset = BinaryDeserializer::Deserialize<CachedAsset>(stream);
+      if (asset->key == key) {
+        return asset;
+      }
+    }
+  } catch (std::exception &) {
+  }
+
+  // The file is missing, unreadable, or holds another key.
+  {
+    std::lock_guard<std::mutex> guard(mutex);
+    auto it = entries_by_file_name.find(file_name);
+    if (it == entries_by_file_name.end()) {
+      return nullptr;
+    }
+    Erase(it->second);
+  }
+  RemoveFiles({file_name});
+  return nullptr;
+}
+
+void AssetCache::Put(const CachedAsset &asset) {
+  std::string bytes;
+  StringWriteStream stream(bytes);
+  BinarySerializer::Serialize(asset, stream);
+  if (bytes.size() > capacity_bytes) {
+    return;
+  }
+
+  auto file_name = GetFileName(asset.key);
+  auto path = GetPath(file_name);
+  auto temp_path =
+      path + "." + std::to_string(next_temp_file_id++) + TEMP_FILE_SUFFIX;
+
+  // The rename replaces the previous file of the entry, if any.
+  try {
+    {
+      auto handle =
+          fs->OpenFile(temp_path, FileFlags::FILE_FLAGS_WRITE |
+                                      FileFlags::FILE_FLAGS_FILE_CREATE_NEW);
+      handle->Write(const_cast<char *>(bytes.data()), bytes.size(), 0);
+      handle->Sync();
+    }
+    fs->MoveFile(temp_path, path);
+  } catch (std::exception &) {
+    try {
+      fs->RemoveFile(temp_path);
+    } catch (std::exception &) {
+    }
+    return;
+  }
+
+  vector<std::string> file_names_to_remove;
+  {
+    std::lock_guard<std::mutex> guard(mutex);
+    auto it = entries_by_file_name.find(file_name);
+    if (it != entries_by_file_name.end()) {
+      Erase(it->second);
+    }
+    entries.push_front(Entry{file_name, bytes.size()});
+    entries_by_file_name[file_name] = entries.begin();
+    size_bytes += bytes.size();
+    Evict(file_names_to_remove);
+  }
+  RemoveFiles(file_names_to_remove);
+}
+
+void AssetCache::Load() {
+  // The type of modification times depends on the DuckDB version. Only their
+  // order matters here.
+  using FileTime = decltype(fs->GetLastModifiedTime(
+      std::declval<FileHandle &>()));
+  vector<std::pair<FileTime, Entry>> loaded;
+  vector<std::string> temp_file_names;
+  fs->ListFiles(directory, [&](const std::string &name, bool is_directory) {
+    if (is_directory) {
+      return;
+    }
+    if (StringUtil::EndsWith(name, TEMP_FILE_SUFFIX)) {
+      temp_file_names.push_back(name);
+      return;
+    }
+    if (!StringUtil::EndsWith(name, ASSET_FILE_SUFFIX)) {
+      return;
+    }
+    auto handle = fs->OpenFile(GetPath(name), FileFlags::FILE_FLAGS_READ);
+    loaded.emplace_back(
+        fs->GetLastModifiedTime(*handle),
+        Entry{name, static_cast<idx_t>(handle->GetFileSize())});
+  });
+
+  // Left by runs that stopped while writing an entry.
+  for (auto &name : temp_file_names) {
+    fs->RemoveFile(GetPath(name));
+  }
+
+  std::sort(loaded.begin(), loaded.end(),
+            [](const std::pair<FileTime, Entry> &a,
+               const std::pair<FileTime, Entry> &b) {
+              return b.first < a.first;
+            });
+  vector<std::string> file_names_to_remove;
+  {
+    std::lock_guard<std::mutex> guard(mutex);
+    for (auto &item : loaded) {
+      entries.push_back(item.second);
+      entries_by_file_name[item.second.file_name] = std::prev(entries.end());
+      size_bytes += item.second.size_bytes;
+    }
+    // The capacity may have been lowered since the previous run.
+    Evict(file_names_to_remove);
+  }
+  RemoveFiles(file_names_to_remove);
+}
+
+std::string AssetCache::GetPath(const std::string &file_name) const {
+  return fs->JoinPath(directory, file_name);
+}
+
+void AssetCache::Evict(vector<std::string> &file_names_to_remove) {
+  while (size_bytes > capacity_bytes && !entries.empty()) {
+    auto it = std::prev(entries.end());
+    file_names_to_remove.push_back(it->file_name);
+    Erase(it);
+  }
+}
+
+void AssetCache::Erase(std::list<Entry>::iterator it) {
+  size_bytes -= it->size_bytes;
+  entries_by_file_name.erase(it->file_name);
+  entries.erase(it);
+}
+
+// A file removed here may have been written again for a new entry meanwhile.
+// Reading that entry then fails, and drops it, like any missing file.
+void AssetCache::RemoveFiles(const vector<std::string> &file_names) {
+  for (auto &file_name : file_names) {
+    try {
+      fs->RemoveFile(GetPath(file_name));
+    } catch (std::exception &) {
+    }
+  }
+}
+
+} // namespace ui
+} // namespace duckdb
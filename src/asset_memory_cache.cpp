@@ -0,0 +1,118 @@
+#include "asset_memory_cache.hpp"
+
+namespace duckdb {
+namespace ui {
+
+// Smaller assets gain too little from compression to be worth it.
+constexpr idx_t MIN_COMPRESSED_SIZE = 1024;
+
+const std::string &
+MemoryCachedAsset::GetBody(ContentEncoding &encoding) const {
+  if (encoding == ContentEncoding::ZSTD && !zstd_body.empty()) {
+    return zstd_body;
+  }
+  if (encoding == ContentEncoding::GZIP && !gzip_body.empty()) {
+    return gzip_body;
+  }
+  encoding = ContentEncoding::NONE;
+  return asset.body;
+}
+
+idx_t MemoryCachedAsset::GetSizeBytes() const {
+  idx_t size = asset.key.size() + asset.body.size() + gzip_body.size() +
+               zstd_body.size();
+  for (idx_t i = 0; i < asset.header_names.size(); i++) {
+    size += asset.header_names[i].size() + asset.header_values[i].size();
+  }
+  return size;
+}
+
+// Text formats compress well. Images (other than SVG), fonts and archives are
+// compressed already.
+static bool IsCompressible(const CachedAsset &asset) {
+  if (asset.body.size() < MIN_COMPRESSED_SIZE ||
+      !asset.GetHeader("Content-Encoding").empty()) {
+    return false;
+  }
+  auto content_type = StringUtil::Lower(asset.GetHeader("Content-Type"));
+  return StringUtil::StartsWith(content_type, "text/") ||
+         StringUtil::Contains(content_type, "javascript") ||
+         StringUtil::Contains(content_type, "json") ||
+         StringUtil::Contains(content_type, "xml") ||
+         StringUtil::StartsWith(content_type, "application/wasm");
+}
+
+static std::string Compress(ContentEncoding encoding, const std::string &body) {
+  std::string compressed;
+  ResponseCompressor::Create(encoding)->Compress(body.data(), body.size(), true,
+                                                 compressed);
+  if (compressed.size() >= body.size()) {
+    return std::string();
+  }
+  return compressed;
+}
+
+AssetMemoryCache::AssetMemoryCache(idx_t _capacity_bytes)
+    : capacity_bytes(_capacity_bytes) {}
+
+shared_ptr<const MemoryCachedAsset>
+AssetMemoryCache::Get(const std::string &key, ContentEncoding encoding) {
+  shared_ptr<const MemoryCachedAsset> asset;
+  {
+    std::lock_guard<std::mutex> guard(mutex);
+    auto it = entries_by_key.find(key);
+    if (it == entries_by_key.end()) {
+      misses++;
+      return nullptr;
+    }
+    entries.splice(entries.begin(), entries, it->second);
+    asset = *it->second;
+  }
+
+  hits++;
+  auto &body = asset->GetBody(encoding);
+  bytes_served += body.size();
+  bytes_saved += asset->asset.body.size() - body.size();
+  return asset;
+}
+
+void AssetMemoryCache::Put(CachedAsset asset) {
+  auto entry = make_shared_ptr<MemoryCachedAsset>();
+  entry->asset = std::move(asset);
+  // Compressed outside the lock, as it takes a while for large assets.
+  if (IsCompressible(entry->asset)) {
+    entry->gzip_body = Compress(ContentEncoding::GZIP, entry->asset.body);
+    entry->zstd_body = Compress(ContentEncoding::ZSTD, entry->asset.body);
+  }
+  auto entry_size = entry->GetSizeBytes();
+  if (entry_size > capacity_bytes) {
+    return;
+  }
+
+  auto &key = entry->asset.key;
+  std::lock_guard<std::mutex> guard(mutex);
+  auto it = entries_by_key.find(key);
+  if (it != entries_by_key.end()) {
+    Erase(it->second);
+  }
+  while (size_bytes + entry_size > capacity_bytes) {
+    Erase(std::prev(entries.end()));
+  }
+  entries.push_front(std::move(entry));
+  entries_by_key[key] = entries.begin();
+  size_bytes += entry_size;
+}
+
+AssetMemoryCache::Stats AssetMemoryCache::GetStats() {
+  std::lock_guard<std::mutex> guard(mutex);
+  return {hits, misses, entries.size(), size_bytes, bytes_served, bytes_saved};
+}
+
+void AssetMemoryCache::Erase(std::list<Entry>::iterator it) {
+  size_bytes -= (*it)->GetSizeBytes();
+  entries_by_key.erase((*it)->asset.key);
+  entries.erase(it);
+}
+
+} // namespace ui
+} // namespace duckdb
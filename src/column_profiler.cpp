@@ -0,0 +1,306 @@
+#include "column_profiler.hpp"
+
+#include <duckdb/common/operator/cast_operators.hpp>
+#include <duckdb/common/operator/comparison_operators.hpp>
+
+#include <cmath>
+
+// Number of bins of the column histograms.
+#define HISTOGRAM_BIN_COUNT 32
+
+namespace duckdb {
+namespace ui {
+
+namespace {
+
+// Range updates for the values of types with histograms.
+struct NumericRange {
+  template <class T>
+  static void Update(ColumnProfiler::ColumnState &state, T min, T max) {
+    auto min_double = Cast::Operation<T, double>(min) / state.scale;
+    auto max_double = Cast::Operation<T, double>(max) / state.scale;
+    // Non-finite values are left out of the histogram.
+    if (!std::isfinite(min_double) || !std::isfinite(max_double)) {
+      return;
+    }
+    if (!state.has_range || min_double < state.range_min) {
+      state.range_min = min_double;
+    }
+    if (!state.has_range || max_double > state.range_max) {
+      state.range_max = max_double;
+    }
+    state.has_range = true;
+  }
+};
+
+struct NoRange {
+  template <class T>
+  static void Update(ColumnProfiler::ColumnState &state, T min, T max) {}
+};
+
+template <class T, class RANGE>
+void UpdateMinMax(ColumnProfiler::ColumnState &state, Vector &vector,
+                  UnifiedVectorFormat &format, idx_t count) {
+  auto data = UnifiedVectorFormat::GetData<T>(format);
+  // Find the rows of the smallest and largest values of the chunk, so only two
+  // values have to be compared with those of the previous chunks.
+  optional_idx min_row;
+  optional_idx max_row;
+  idx_t min_index = 0;
+  idx_t max_index = 0;
+  for (idx_t i = 0; i < count; i++) {
+    auto index = format.sel->get_index(i);
+    if (!format.validity.RowIsValid(index)) {
+      continue;
+    }
+    if (!min_row.IsValid() ||
+        LessThan::Operation<T>(data[index], data[min_index])) {
+      min_row = i;
+      min_index = index;
+    }
+    if (!max_row.IsValid() ||
+        GreaterThan::Operation<T>(data[index], data[max_index])) {
+      max_row = i;
+      max_index = index;
+    }
+  }
+  if (!min_row.IsValid()) {
+    return;
+  }
+
+  auto min = vector.GetValue(min_row.GetIndex());
+  auto max = vector.GetValue(max_row.GetIndex());
+  if (state.min.IsNull() || min < state.min) {
+    state.min = min;
+  }
+  if (state.max.IsNull() || max > state.max) {
+    state.max = max;
+  }
+  RANGE::template Update<T>(state, data[min_index], data[max_index]);
+}
+
+template <class T>
+void AddToHistogram(ColumnProfiler::ColumnState &state, Vector &vector,
+                    idx_t count) {
+  UnifiedVectorFormat format;
+  vector.ToUnifiedFormat(count, format);
+  auto data = UnifiedVectorFormat::GetData<T>(format);
+  auto bin_width = (state.range_max - state.range_min) / HISTOGRAM_BIN_COUNT;
+  for (idx_t i = 0; i < count; i++) {
+    auto index = format.sel->get_index(i);
+    if (!format.validity.RowIsValid(index)) {
+      continue;
+    }
+    auto value = Cast::Operation<T, double>(data[index]) / state.scale;
+    if (!std::isfinite(value)) {
+      continue;
+    }
+    idx_t bin = 0;
+    if (bin_width > 0 && value > state.range_min) {
+      bin = MinValue<idx_t>(
+          static_cast<idx_t>((value - state.range_min) / bin_width),
+          HISTOGRAM_BIN_COUNT - 1);
+    }
+    state.histogram_counts[bin]++;
+  }
+}
+
+} // namespace
+
+ColumnProfiler::ColumnProfiler(const vector<LogicalType> &types) {
+  for (auto &type : types) {
+    ColumnState state;
+    state.type = type;
+    switch (type.id()) {
+    case LogicalTypeId::DECIMAL:
+      state.scale = std::pow(10.0, DecimalType::GetScale(type));
+      state.ordered = true;
+      state.numeric = true;
+      break;
+    case LogicalTypeId::TINYINT:
+    case LogicalTypeId::SMALLINT:
+    case LogicalTypeId::INTEGER:
+    case LogicalTypeId::BIGINT:
+    case LogicalTypeId::HUGEINT:
+    case LogicalTypeId::UTINYINT:
+    case LogicalTypeId::USMALLINT:
+    case LogicalTypeId::UINTEGER:
+    case LogicalTypeId::UBIGINT:
+    case LogicalTypeId::UHUGEINT:
+    case LogicalTypeId::FLOAT:
+    case LogicalTypeId::DOUBLE:
+    case LogicalTypeId::DATE:
+    case LogicalTypeId::TIME:
+    case LogicalTypeId::TIMESTAMP_SEC:
+    case LogicalTypeId::TIMESTAMP_MS:
+    case LogicalTypeId::TIMESTAMP:
+    case LogicalTypeId::TIMESTAMP_NS:
+    case LogicalTypeId::TIMESTAMP_TZ:
+      state.ordered = true;
+      state.numeric = true;
+      break;
+    case LogicalTypeId::BOOLEAN:
+    case LogicalTypeId::VARCHAR:
+      state.ordered = true;
+      break;
+    default:
+      break;
+    }
+    columns.push_back(std::move(state));
+  }
+}
+
+void ColumnProfiler::Update(Chunk &chunk) {
+  idx_t count = chunk.row_count;
+  Vector hashes(LogicalType::HASH, count);
+  for (idx_t i = 0; i < columns.size(); i++) {
+    auto &state = columns[i];
+    auto &vector = chunk.vectors[i];
+
+    UnifiedVectorFormat format;
+    vector.ToUnifiedFormat(count, format);
+    if (!format.validity.AllValid()) {
+      for (idx_t row = 0; row < count; row++) {
+        if (!format.validity.RowIsValid(format.sel->get_index(row))) {
+          state.null_count++;
+        }
+      }
+    }
+
+    state.distinct.Update(vector, hashes, count);
+
+    if (!state.ordered) {
+      continue;
+    }
+    switch (vector.GetType().InternalType()) {
+    case PhysicalType::BOOL:
+      UpdateMinMax<bool, NoRange>(state, vector, format, count);
+      break;
+    case PhysicalType::INT8:
+      UpdateMinMax<int8_t, NumericRange>(state, vector, format, count);
+      break;
+    case PhysicalType::INT16:
+      UpdateMinMax<int16_t, NumericRange>(state, vector, format, count);
+      break;
+    case PhysicalType::INT32:
+      UpdateMinMax<int32_t, NumericRange>(state, vector, format, count);
+      break;
+    case PhysicalType::INT64:
+      UpdateMinMax<int64_t, NumericRange>(state, vector, format, count);
+      break;
+    case PhysicalType::INT128:
+      UpdateMinMax<hugeint_t, NumericRange>(state, vector, format, count);
+      break;
+    case PhysicalType::UINT8:
+      UpdateMinMax<uint8_t, NumericRange>(state, vector, format, count);
+      break;
+    case PhysicalType::UINT16:
+      UpdateMinMax<uint16_t, NumericRange>(state, vector, format, count);
+      break;
+    case PhysicalType::UINT32:
+      UpdateMinMax<uint32_t, NumericRange>(state, vector, format, count);
+      break;
+    case PhysicalType::UINT64:
+      UpdateMinMax<uint64_t, NumericRange>(state, vector, format, count);
+      break;
+    case PhysicalType::UINT128:
+      UpdateMinMax<uhugeint_t, NumericRange>(state, vector, format, count);
+      break;
+    case PhysicalType::FLOAT:
+      UpdateMinMax<float, NumericRange>(state, vector, format, count);
+      break;
+    case PhysicalType::DOUBLE:
+      UpdateMinMax<double, NumericRange>(state, vector, format, count);
+      break;
+    case PhysicalType::VARCHAR:
+      UpdateMinMax<string_t, NoRange>(state, vector, format, count);
+      break;
+    default:
+      break;
+    }
+  }
+}
+
+vector<ColumnProfile> ColumnProfiler::Finish(vector<Chunk> &chunks) {
+  for (auto &chunk : chunks) {
+    AddToHistograms(chunk);
+  }
+  return Finish();
+}
+
+void ColumnProfiler::AddToHistograms(Chunk &chunk) {
+  for (idx_t i = 0; i < columns.size(); i++) {
+    auto &state = columns[i];
+    if (!state.numeric || !state.has_range) {
+      continue;
+    }
+    if (state.histogram_counts.empty()) {
+      state.histogram_counts.resize(HISTOGRAM_BIN_COUNT);
+    }
+    auto &vector = chunk.vectors[i];
+    switch (vector.GetType().InternalType()) {
+    case PhysicalType::INT8:
+      AddToHistogram<int8_t>(state, vector, chunk.row_count);
+      break;
+    case PhysicalType::INT16:
+      AddToHistogram<int16_t>(state, vector, chunk.row_count);
+      break;
+    case PhysicalType::INT32:
+      AddToHistogram<int32_t>(state, vector, chunk.row_count);
+      break;
+    case PhysicalType::INT64:
+      AddToHistogram<int64_t>(state, vector, chunk.row_count);
+      break;
+    case PhysicalType::INT128:
+      AddToHistogram<hugeint_t>(state, vector, chunk.row_count);
+      break;
+    case PhysicalType::UINT8:
+      AddToHistogram<uint8_t>(state, vector, chunk.row_count);
+      break;
+    case PhysicalType::UINT16:
+      AddToHistogram<uint16_t>(state, vector, chunk.row_count);
+      break;
+    case PhysicalType::UINT32:
+      AddToHistogram<uint32_t>(state, vector, chunk.row_count);
+      break;
+    case PhysicalType::UINT64:
+      AddToHistogram<uint64_t>(state, vector, chunk.row_count);
+      break;
+    case PhysicalType::UINT128:
+      AddToHistogram<uhugeint_t>(state, vector, chunk.row_count);
+      break;
+    case PhysicalType::FLOAT:
+      AddToHistogram<float>(state, vector, chunk.row_count);
+      break;
+    case PhysicalType::DOUBLE:
+      AddToHistogram<double>(state, vector, chunk.row_count);
+      break;
+    default:
+      break;
+    }
+  }
+}
+
+vector<ColumnProfile> ColumnProfiler::Finish() {
+  vector<ColumnProfile> profiles;
+  for (auto &state : columns) {
+    ColumnProfile profile;
+    profile.null_count = state.null_count;
+    profile.distinct_count_estimate = state.distinct.Count();
+    if (!state.min.IsNull()) {
+      profile.has_min_max = true;
+      profile.min = state.min.ToString();
+      profile.max = state.max.ToString();
+    }
+    if (!state.histogram_counts.empty()) {
+      profile.histogram_min = state.range_min;
+      profile.histogram_max = state.range_max;
+      profile.histogram_counts = std::move(state.histogram_counts);
+    }
+    profiles.push_back(std::move(profile));
+  }
+  return profiles;
+}
+
+} // namespace ui
+} // namespace duckdb
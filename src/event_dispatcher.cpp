@@ -63,6 +63,62 @@ void EventDispatcher::SendCatalogChangedEvent() {
   SendEvent("event: CatalogChangeEvent\ndata:\n\n");
 }
 
+static std::string ToJSONString(const std::string &value) {
+  std::string result = "\"";
+  for (auto c : value) {
+    switch (c) {
+    case '"':
+      result += "\\\"";
+      break;
+    case '\\':
+      result += "\\\\";
+      break;
+    default:
+      if (static_cast<unsigned char>(c) < 0x20) {
+        result += StringUtil::Format("\\u%04x", static_cast<int>(c));
+      } else {
+        result += c;
+      }
+    }
+  }
+  return result + "\"";
+}
+
+void EventDispatcher::SendResultTableMaterializedEvent(
+    const std::string &connection_name, const std::string &database_name,
+    const std::string &schema_name, const std::string &table_name,
+    uint64_t row_count, int64_t elapsed_ms, const std::string &error) {
+  auto data = StringUtil::Format(
+      "{\"connectionName\":%s,\"databaseName\":%s,\"schemaName\":%s,"
+      "\"tableName\":%s,\"rowCount\":%s,\"elapsedMs\":%s",
+      ToJSONString(connection_name), ToJSONString(database_name),
+      ToJSONString(schema_name), ToJSONString(table_name),
+      std::to_string(row_count), std::to_string(elapsed_ms));
+  if (!error.empty()) {
+    data += ",\"error\":" + ToJSONString(error);
+  }
+  data += "}";
+  SendEvent(StringUtil::Format(
+      "event: ResultTableMaterializedEvent\ndata: %s\n\n", data));
+}
+
+void EventDispatcher::SendQueryProgressEvent(
+    const std::string &connection_name, uint64_t rows_processed,
+    uint64_t total_rows_to_process, double percentage) {
+  auto data = StringUtil::Format(
+      "{\"connectionName\":%s,\"rowsProcessed\":%s,"
+      "\"totalRowsToProcess\":%s",
+      ToJSONString(connection_name), std::to_string(rows_processed),
+      std::to_string(total_rows_to_process));
+  if (percentage >= 0) {
+    data += StringUtil::Format(",\"percentComplete\":%.1f",
+                               MinValue(percentage, 100.0));
+  }
+  data += "}";
+  SendEvent(StringUtil::Format("event: QueryProgressEvent\ndata: %s\n\n",
+                               data));
+}
+
 void EventDispatcher::Close() {
   std::lock_guard<std::mutex> guard(mutex);
   if (closed) {
@@ -1,27 +1,156 @@
 #include "http_server.hpp"
 
+#include "column_profiler.hpp"
 #include "event_dispatcher.hpp"
+#include "prepared_statement_cache.hpp"
+#include "reservoir_sampler.hpp"
+#include "result_cache.hpp"
+#include "result_reader.hpp"
 #include "settings.hpp"
+#include "spilled_result.hpp"
 #include "state.hpp"
+#include "utils/arrow_ipc.hpp"
+#include "utils/compression.hpp"
 #include "utils/encoding.hpp"
 #include "utils/env.hpp"
 #include "utils/md_helpers.hpp"
 #include "utils/serialization.hpp"
 #include "version.hpp"
 #include "watcher.hpp"
+#include <duckdb/catalog/catalog_search_path.hpp>
 #include <duckdb/common/http_util.hpp>
+#include <duckdb/common/serializer/binary_deserializer.hpp>
 #include <duckdb/common/serializer/binary_serializer.hpp>
 #include <duckdb/common/serializer/memory_stream.hpp>
+#include <duckdb/common/types/uuid.hpp>
 #include <duckdb/main/attached_database.hpp>
 #include <duckdb/main/client_data.hpp>
-#include <duckdb/parser/parsed_data/create_table_info.hpp>
+#include <duckdb/parser/keyword_helper.hpp>
 #include <duckdb/parser/parser.hpp>
 
+// Responses smaller than this are not compressed.
+#define MIN_COMPRESSED_RESPONSE_SIZE 1024
+// Server threads left for requests other than running or queued queries.
+#define RESERVED_THREAD_COUNT 8
+// How often running queries check whether their client has disconnected.
+#define CLIENT_POLL_INTERVAL_MS 100
+// Where responses proxied from the remote URL are cached.
+#define ASSET_CACHE_DIRECTORY "~/.duckdb/extension_data/ui/assets"
+// Where asset bundles for offline use are installed, as
+// bundle-<install time>.tar. The latest one is used.
+#define ASSET_BUNDLE_DIRECTORY "~/.duckdb/extension_data/ui"
+#define ASSET_BUNDLE_PREFIX "bundle-"
+#define ASSET_BUNDLE_SUFFIX ".tar"
+// Size of the pieces files are copied in.
+#define COPY_BUFFER_SIZE (1024 * 1024)
+// Size of the pieces a spilled result is written to the client in.
+#define SINK_BUFFER_SIZE (64 * 1024)
+// Most rows result chunks are combined into, whatever the request asks for.
+#define MAX_RESULT_BATCH_SIZE (1024 * 1024)
+// Assets fetched at once when the server warms up.
+#define PREFETCH_THREAD_COUNT 4
+// Longest the warm-up waits to connect to the remote URL. Stopping the server
+// waits for it, so it is kept short, whatever http_timeout is.
+#define PREFETCH_CONNECTION_TIMEOUT_S 5
+
+#ifdef _WIN32
+// avoid being transformed to `CreateDirectoryA` and `MoveFileA`
+#undef CreateDirectory
+#undef MoveFile
+#endif
+
 namespace duckdb {
 namespace ui {
 
 unique_ptr<HttpServer> HttpServer::server_instance;
 
+// Serializes the result straight into the response body, which httplib writes
+// to the socket as is. Large results are never copied as a whole.
+template <class T>
+static void SetResponseResult(httplib::Response &res, const T &result) {
+  res.body.clear();
+  StringWriteStream stream(res.body);
+  BinarySerializer::Serialize(result, stream);
+  res.set_header("Content-Type", "application/octet-stream");
+}
+
+// Returns the version of the result serialization asked for by the request,
+// limited to the latest one.
+static idx_t GetSerializationVersion(const httplib::Request &req) {
+  auto version_string =
+      req.get_header_value("X-DuckDB-UI-Serialization-Version");
+  if (version_string.empty()) {
+    return 1;
+  }
+  return MinValue<idx_t>(std::stoull(version_string),
+                         UI_SERIALIZATION_VERSION);
+}
+
+// Reads the X-DuckDB-UI-Result-Batch-Size header, if given, into
+// `batch_size`. Returns false if it isn't a number.
+static bool ReadRequestBatchSize(const httplib::Request &req,
+                                 optional_idx &batch_size) {
+  auto batch_size_string =
+      req.get_header_value("X-DuckDB-UI-Result-Batch-Size");
+  if (batch_size_string.empty()) {
+    return true;
+  }
+  for (auto c : batch_size_string) {
+    if (!StringUtil::CharacterIsDigit(c)) {
+      return false;
+    }
+  }
+  // Longer numbers are clamped anyway, and might not fit.
+  batch_size = batch_size_string.size() > 9
+                   ? MAX_RESULT_BATCH_SIZE
+                   : std::stoull(batch_size_string);
+  return true;
+}
+
+// Returns the number of rows to combine result chunks into: the batch size
+// requested if any, otherwise the ui_result_batch_size setting, up to
+// MAX_RESULT_BATCH_SIZE. Only clients reading serialization version 3 or Arrow
+// streams accept chunks larger than STANDARD_VECTOR_SIZE.
+static idx_t GetBatchSize(optional_idx request_batch_size,
+                          const ClientContext &context) {
+  auto batch_size = request_batch_size.IsValid()
+                        ? request_batch_size.GetIndex()
+                        : GetResultBatchSize(context);
+  return MinValue<idx_t>(batch_size, MAX_RESULT_BATCH_SIZE);
+}
+
+// Returns the name result tables being filled are tracked by.
+static std::string GetResultTableKey(const std::string &database_name,
+                                     const std::string &schema_name,
+                                     const std::string &table_name) {
+  return KeywordHelper::WriteOptionallyQuoted(database_name) + "." +
+         KeywordHelper::WriteOptionallyQuoted(schema_name) + "." +
+         KeywordHelper::WriteOptionallyQuoted(table_name);
+}
+
+// Returns a function telling whether the client of the request handled by the
+// calling thread has disconnected. Polling the socket is a system call, so it
+// is done at most once per interval. Once the client is gone, the answer
+// doesn't change.
+static std::function<bool()> MakeClientGoneCheck() {
+  auto sock = SocketTrackingServer::GetCurrentSocket();
+  auto gone = false;
+  auto next_poll = std::chrono::steady_clock::now() +
+                   std::chrono::milliseconds(CLIENT_POLL_INTERVAL_MS);
+  return [sock, gone, next_poll]() mutable {
+    if (gone) {
+      return true;
+    }
+    auto now = std::chrono::steady_clock::now();
+    if (now < next_poll) {
+      return false;
+    }
+    next_poll = now + std::chrono::milliseconds(CLIENT_POLL_INTERVAL_MS);
+    gone = !SocketTrackingServer::IsClientConnected(sock);
+    return gone;
+  };
+}
+
 HttpServer *HttpServer::GetInstance(ClientContext &context) {
   if (server_instance) {
     // We already have an instance, make sure we're running on the right DB
@@ -83,6 +212,25 @@ void HttpServer::StopInstance() {
   }
 }
 
+// Returns the path of the latest bundle installed in `directory`, or an empty
+// string if there is none. Install times are zero-padded, so the latest bundle
+// has the greatest name.
+static std::string FindInstalledBundle(FileSystem &fs,
+                                       const std::string &directory) {
+  std::string latest_name;
+  if (!fs.DirectoryExists(directory)) {
+    return latest_name;
+  }
+  fs.ListFiles(directory, [&](const std::string &name, bool is_directory) {
+    if (!is_directory && StringUtil::StartsWith(name, ASSET_BUNDLE_PREFIX) &&
+        StringUtil::EndsWith(name, ASSET_BUNDLE_SUFFIX) && name > latest_name) {
+      latest_name = name;
+    }
+  });
+  return latest_name.empty() ? latest_name
+                             : fs.JoinPath(directory, latest_name);
+}
+
 const HttpServer &HttpServer::Start(ClientContext &context, bool *was_started) {
   if (Started()) {
     if (was_started) {
@@ -100,14 +248,32 @@ const HttpServer &HttpServer::Start(ClientContext &context, bool *was_started) {
   auto &http_util = HTTPUtil::Get(*context.db);
   // FIXME - https://github.com/duckdb/duckdb/pull/17655 will remove `unused`
   auto http_params = http_util.InitializeParameters(context, "unused");
+  auto result_cache_size = GetResultCacheSize(context);
+  auto max_concurrent_runs = GetMaxConcurrentRuns(context);
+  auto max_queued_runs = GetMaxQueuedRuns(context);
+  auto &fs = FileSystem::GetFileSystem(context);
+  auto asset_cache_directory = fs.ExpandPath(ASSET_CACHE_DIRECTORY);
+  auto asset_cache_size = GetAssetCacheSize(context);
+  auto asset_memory_cache_size = GetAssetMemoryCacheSize(context);
+  auto asset_bundle_path =
+      FindInstalledBundle(fs, fs.ExpandPath(ASSET_BUNDLE_DIRECTORY));
   auto server = GetInstance(context);
-  server->DoStart(port, remote_url, std::move(http_params));
+  server->DoStart(port, remote_url, std::move(http_params), result_cache_size,
+                  max_concurrent_runs, max_queued_runs, asset_cache_directory,
+                  asset_cache_size, asset_memory_cache_size,
+                  asset_bundle_path);
   return *server;
 }
 
 void HttpServer::DoStart(const uint16_t _local_port,
                          const std::string &_remote_url,
-                         unique_ptr<HTTPParams> _http_params) {
+                         unique_ptr<HTTPParams> _http_params,
+                         idx_t result_cache_size,
+                         idx_t max_concurrent_runs, idx_t max_queued_runs,
+                         const std::string &asset_cache_directory,
+                         idx_t asset_cache_size,
+                         idx_t asset_memory_cache_size,
+                         const std::string &asset_bundle_path) {
   if (Started()) {
     throw std::runtime_error("HttpServer already started");
   }
@@ -120,9 +286,43 @@ void HttpServer::DoStart(const uint16_t _local_port,
       StringUtil::Format("duckdb-ui/%s-%s(%s)", DuckDB::LibraryVersion(),
                          UI_EXTENSION_VERSION, DuckDB::Platform());
   event_dispatcher = make_uniq<EventDispatcher>();
+  result_cache = make_uniq<ResultCache>(result_cache_size);
+  run_scheduler = make_uniq<RunScheduler>(max_concurrent_runs, max_queued_runs);
+  // Running and queued queries each hold a thread, so leave enough threads for
+  // the other requests (events, tokenizing, catalog queries) on top of them.
+  server_thread_count =
+      MaxValue<idx_t>(CPPHTTPLIB_THREAD_POOL_COUNT,
+                      max_concurrent_runs + max_queued_runs +
+                          RESERVED_THREAD_COUNT);
+  // Each server thread may be fetching an asset at once.
+  remote_client_pool = make_uniq<RemoteClientPool>(
+      remote_url, server_thread_count,
+      [this](httplib::Client &client) {
+        InitClientFromParams(client);
+        if (IsEnvEnabled("ui_disable_server_certificate_verification")) {
+          client.enable_server_certificate_verification(false);
+        }
+      });
+  if (asset_cache_size > 0) {
+    asset_cache =
+        make_uniq<AssetCache>(asset_cache_directory, asset_cache_size);
+  }
+  if (asset_memory_cache_size > 0) {
+    asset_memory_cache = make_uniq<AssetMemoryCache>(asset_memory_cache_size);
+  }
+  // Work offline if a bundle has been installed. A bundle that can't be read
+  // is ignored, and can be replaced using LoadAssetBundle.
+  if (!asset_bundle_path.empty()) {
+    try {
+      asset_bundle = make_shared_ptr<AssetBundle>(asset_bundle_path);
+    } catch (std::exception &) {
+    }
+  }
   main_thread = make_uniq<std::thread>(&HttpServer::Run, this);
   watcher = make_uniq<Watcher>(*this);
   watcher->Start();
+  warm_up_stopped = false;
+  warm_up_thread = make_uniq<std::thread>(&HttpServer::WarmUp, this);
 }
 
 bool HttpServer::Stop() {
@@ -137,7 +337,11 @@ bool HttpServer::Stop() {
 void HttpServer::DoStop() {
   if (event_dispatcher) {
     event_dispatcher->Close();
-    event_dispatcher = nullptr;
+  }
+  // Queued requests hold server threads, which must return for the server to
+  // stop.
+  if (run_scheduler) {
+    run_scheduler->Close();
   }
   server.stop();
 
@@ -146,17 +350,277 @@ void HttpServer::DoStop() {
     watcher = nullptr;
   }
 
+  // Stops after the assets being fetched, as it uses the remote clients and
+  // the caches. Their requests are cancelled, so it doesn't wait for the
+  // remote URL (e.g. while offline).
+  warm_up_stopped = true;
+  if (remote_client_pool) {
+    remote_client_pool->Stop();
+  }
+  if (warm_up_thread) {
+    warm_up_thread->join();
+    warm_up_thread.reset();
+  }
+
   if (main_thread) {
     main_thread->join();
     main_thread.reset();
   }
 
+  // Materializers report to the event dispatcher, so it must outlive them.
+  StopMaterializers();
+  event_dispatcher = nullptr;
+
   ddb_instance.reset();
   http_params = nullptr;
+  result_cache = nullptr;
+  run_scheduler = nullptr;
+  remote_client_pool = nullptr;
+  asset_cache = nullptr;
+  asset_memory_cache = nullptr;
+  {
+    std::lock_guard<std::mutex> guard(asset_bundle_mutex);
+    asset_bundle = nullptr;
+  }
   remote_url = "";
   local_port = 0;
 }
 
+ResultCache::Stats HttpServer::GetResultCacheStats() const {
+  if (!result_cache) {
+    return {0, 0, 0, 0};
+  }
+  return result_cache->GetStats();
+}
+
+RunScheduler::Stats HttpServer::GetRunSchedulerStats() const {
+  if (!run_scheduler) {
+    return {0, 0, 0, 0, 0, std::chrono::microseconds(0),
+            std::chrono::microseconds(0)};
+  }
+  return run_scheduler->GetStats();
+}
+
+AssetMemoryCache::Stats HttpServer::GetAssetMemoryCacheStats() const {
+  if (!asset_memory_cache) {
+    return {0, 0, 0, 0, 0, 0};
+  }
+  return asset_memory_cache->GetStats();
+}
+
+static void CopyFile(FileSystem &fs, const std::string &source_path,
+                     const std::string &target_path) {
+  auto source = fs.OpenFile(source_path, FileFlags::FILE_FLAGS_READ);
+  auto target =
+      fs.OpenFile(target_path, FileFlags::FILE_FLAGS_WRITE |
+                                   FileFlags::FILE_FLAGS_FILE_CREATE_NEW);
+  std::string buffer(COPY_BUFFER_SIZE, '\0');
+  auto buffer_data = const_cast<char *>(buffer.data());
+  while (true) {
+    auto read_count = source->Read(buffer_data, buffer.size());
+    if (read_count <= 0) {
+      break;
+    }
+    target->Write(buffer_data, static_cast<idx_t>(read_count));
+  }
+  target->Sync();
+}
+
+// Creates `directory` and its missing parents, e.g. if the home directory
+// has no .duckdb directory yet.
+static void CreateDirectories(FileSystem &fs, const std::string &directory) {
+  if (directory.empty() || fs.DirectoryExists(directory)) {
+    return;
+  }
+  auto separator = directory.find_last_of("/\\");
+  if (separator != std::string::npos && separator > 0) {
+    CreateDirectories(fs, directory.substr(0, separator));
+  }
+  fs.CreateDirectory(directory);
+}
+
+shared_ptr<AssetBundle>
+HttpServer::LoadAssetBundle(ClientContext &context,
+                            const std::string &source_path) {
+  auto &fs = FileSystem::GetFileSystem(context);
+  auto directory = fs.ExpandPath(ASSET_BUNDLE_DIRECTORY);
+  auto bundle_path = FindInstalledBundle(fs, directory);
+  if (!source_path.empty()) {
+    // Each bundle is installed under a new name, because the previous one may
+    // still be mapped (by the server, or responses in flight), and Windows
+    // doesn't allow replacing mapped files. The copy is checked before it is
+    // given its final name.
+    auto install_time = std::to_string(
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::system_clock::now().time_since_epoch())
+            .count());
+    install_time.insert(0, 20 - MinValue<size_t>(install_time.size(), 20),
+                        '0');
+    auto new_bundle_path = fs.JoinPath(
+        directory, ASSET_BUNDLE_PREFIX + install_time + ASSET_BUNDLE_SUFFIX);
+    auto temp_path = new_bundle_path + ".tmp";
+    try {
+      CreateDirectories(fs, directory);
+      CopyFile(fs, source_path, temp_path);
+      AssetBundle check(temp_path);
+    } catch (std::exception &) {
+      fs.TryRemoveFile(temp_path);
+      throw;
+    }
+    fs.MoveFile(temp_path, new_bundle_path);
+
+    // Previous bundles that are still mapped on Windows are removed by a later
+    // install.
+    vector<std::string> old_names;
+    fs.ListFiles(directory, [&](const std::string &name, bool is_directory) {
+      if (!is_directory && StringUtil::StartsWith(name, ASSET_BUNDLE_PREFIX) &&
+          StringUtil::EndsWith(name, ASSET_BUNDLE_SUFFIX) &&
+          fs.JoinPath(directory, name) != new_bundle_path) {
+        old_names.push_back(name);
+      }
+    });
+    for (auto &name : old_names) {
+      fs.TryRemoveFile(fs.JoinPath(directory, name));
+    }
+    bundle_path = new_bundle_path;
+  }
+  if (bundle_path.empty()) {
+    throw IOException("No asset bundle installed in '%s'", directory);
+  }
+
+  auto bundle = make_shared_ptr<AssetBundle>(bundle_path);
+  if (Started()) {
+    auto server = GetInstance(context);
+    std::lock_guard<std::mutex> guard(server->asset_bundle_mutex);
+    server->asset_bundle = bundle;
+  }
+  return bundle;
+}
+
+idx_t HttpServer::UnloadAssetBundle(ClientContext &context) {
+  if (Started()) {
+    auto server = GetInstance(context);
+    std::lock_guard<std::mutex> guard(server->asset_bundle_mutex);
+    server->asset_bundle = nullptr;
+  }
+
+  auto &fs = FileSystem::GetFileSystem(context);
+  auto directory = fs.ExpandPath(ASSET_BUNDLE_DIRECTORY);
+  if (!fs.DirectoryExists(directory)) {
+    return 0;
+  }
+  vector<std::string> names;
+  fs.ListFiles(directory, [&](const std::string &name, bool is_directory) {
+    if (!is_directory && StringUtil::StartsWith(name, ASSET_BUNDLE_PREFIX) &&
+        StringUtil::EndsWith(name, ASSET_BUNDLE_SUFFIX)) {
+      names.push_back(name);
+    }
+  });
+  // On Windows, a bundle still mapped by a response in flight can't be
+  // removed yet. That fails the unload, which can be retried.
+  for (auto &name : names) {
+    fs.RemoveFile(fs.JoinPath(directory, name));
+  }
+  return names.size();
+}
+
+void HttpServer::WarmUp() {
+  // Failures are ignored: the UI then just starts cold.
+  {
+    std::lock_guard<std::mutex> guard(asset_bundle_mutex);
+    if (asset_bundle) {
+      return;
+    }
+  }
+  // Prefetched assets are only kept by the caches.
+  if (!asset_cache && !asset_memory_cache) {
+    return;
+  }
+  try {
+    PrefetchAssets();
+  } catch (std::exception &) {
+  }
+}
+
+// Returns the paths of the resources of the same origin referenced by the src
+// and href attributes of an HTML document.
+static vector<std::string> FindAssetReferences(const std::string &html) {
+  static const std::string ATTRIBUTES[] = {"src=\"", "href=\""};
+  vector<std::string> paths;
+  unordered_set<std::string> seen;
+  for (auto &attribute : ATTRIBUTES) {
+    auto pos = html.find(attribute);
+    while (pos != std::string::npos) {
+      auto start = pos + attribute.size();
+      auto end = html.find('"', start);
+      if (end == std::string::npos) {
+        break;
+      }
+      pos = html.find(attribute, end);
+
+      auto path = html.substr(start, end - start);
+      path = path.substr(0, path.find_first_of("?#"));
+      // Skip other origins (with a scheme, or protocol-relative) and inline
+      // data.
+      if (path.empty() || path.find(':') != std::string::npos ||
+          StringUtil::StartsWith(path, "//")) {
+        continue;
+      }
+      if (StringUtil::StartsWith(path, "./")) {
+        path = path.substr(1);
+      } else if (path[0] != '/') {
+        path = "/" + path;
+      }
+      if (path != "/" && seen.insert(path).second) {
+        paths.push_back(std::move(path));
+      }
+    }
+  }
+  return paths;
+}
+
+void HttpServer::PrefetchAssets() {
+  // The document is the manifest of the UI: it references the scripts and
+  // styles the page loads first. Fetching it also resolves the remote URL and
+  // opens a connection to it, which the clients keep alive.
+  httplib::Request manifest_req;
+  manifest_req.path = "/";
+  httplib::Response manifest;
+  if (!ProxyRemoteAsset(manifest_req, manifest, true) ||
+      manifest.status != 200) {
+    return;
+  }
+  auto paths = FindAssetReferences(manifest.body);
+
+  // Each thread takes the next path until all have been fetched. Responses are
+  // only fetched to be cached, so errors are ignored.
+  std::atomic<idx_t> next_path{0};
+  auto fetch = [&]() {
+    while (!warm_up_stopped) {
+      auto i = next_path++;
+      if (i >= paths.size()) {
+        return;
+      }
+      httplib::Request req;
+      req.path = paths[i];
+      httplib::Response res;
+      try {
+        ProxyRemoteAsset(req, res, true);
+      } catch (std::exception &) {
+      }
+    }
+  };
+  vector<std::thread> threads;
+  auto thread_count = MinValue<idx_t>(PREFETCH_THREAD_COUNT, paths.size());
+  for (idx_t i = 1; i < thread_count; i++) {
+    threads.emplace_back(fetch);
+  }
+  fetch();
+  for (auto &thread : threads) {
+    thread.join();
+  }
+}
+
 std::string HttpServer::LocalUrl() const {
   return StringUtil::Format("http://localhost:%d/", local_port);
 }
@@ -184,16 +648,32 @@ void HttpServer::Run() {
               [&](const httplib::Request &req, httplib::Response &res) {
                 HandleInterrupt(req, res);
               });
+  server.Post("/ddb/fetch",
+              [&](const httplib::Request &req, httplib::Response &res) {
+                HandleFetch(req, res);
+                CompressResponseBody(req, res);
+              });
+  server.Post("/ddb/read_result_table",
+              [&](const httplib::Request &req, httplib::Response &res) {
+                HandleReadResultTable(req, res);
+                CompressResponseBody(req, res);
+              });
   server.Post("/ddb/run",
               [&](const httplib::Request &req, httplib::Response &res,
                   const httplib::ContentReader &content_reader) {
                 HandleRun(req, res, content_reader);
+                CompressResponseBody(req, res);
               });
   server.Post("/ddb/tokenize",
               [&](const httplib::Request &req, httplib::Response &res,
                   const httplib::ContentReader &content_reader) {
                 HandleTokenize(req, res, content_reader);
+                CompressResponseBody(req, res);
               });
+  auto thread_count = server_thread_count;
+  server.new_task_queue = [thread_count] {
+    return new httplib::ThreadPool(thread_count);
+  };
   server.listen("localhost", local_port);
 }
 
@@ -203,6 +683,8 @@ void HttpServer::HandleGetInfo(const httplib::Request &req,
   res.set_header("X-DuckDB-Version", DuckDB::LibraryVersion());
   res.set_header("X-DuckDB-Platform", DuckDB::Platform());
   res.set_header("X-DuckDB-UI-Extension-Version", UI_EXTENSION_VERSION);
+  res.set_header("X-DuckDB-UI-Serialization-Version",
+                 std::to_string(UI_SERIALIZATION_VERSION));
   res.set_content("", "text/plain");
 }
 
@@ -271,35 +753,146 @@ void HttpServer::InitClientFromParams(httplib::Client &client) {
   }
 }
 
-void HttpServer::HandleGet(const httplib::Request &req,
-                           httplib::Response &res) {
-  // Create HTTP client to remote URL
-  // TODO: Can this be created once and shared?
-  httplib::Client client(remote_url);
-  InitClientFromParams(client);
+// Responses are cached unless they are specific to the user (they set cookies)
+// or ask not to be stored.
+static bool IsCacheableAsset(const httplib::Response &res) {
+  if (res.status != 200 || res.has_header("Set-Cookie")) {
+    return false;
+  }
+  auto cache_control = StringUtil::Lower(res.get_header_value("Cache-Control"));
+  return !StringUtil::Contains(cache_control, "no-store") &&
+         !StringUtil::Contains(cache_control, "private");
+}
+
+// Headers about the connection the response came over are not stored.
+static bool IsStoredAssetHeader(const std::string &name) {
+  return !StringUtil::CIEquals(name, "Connection") &&
+         !StringUtil::CIEquals(name, "Content-Length") &&
+         !StringUtil::CIEquals(name, "Keep-Alive") &&
+         !StringUtil::CIEquals(name, "Transfer-Encoding");
+}
 
-  if (IsEnvEnabled("ui_disable_server_certificate_verification")) {
-    client.enable_server_certificate_verification(false);
+static CachedAsset MakeCachedAsset(const std::string &key,
+                                   const httplib::Response &res) {
+  CachedAsset asset;
+  asset.key = key;
+  asset.status = res.status;
+  for (auto &header : res.headers) {
+    if (IsStoredAssetHeader(header.first)) {
+      asset.header_names.push_back(header.first);
+      asset.header_values.push_back(header.second);
+    }
   }
+  asset.body = res.body;
+  return asset;
+}
 
-  httplib::Headers headers = {{"User-Agent", user_agent}};
-  auto cookie = req.get_header_value("Cookie");
-  if (!cookie.empty()) {
-    headers.emplace("Cookie", cookie);
+static void SetResponseCachedAsset(httplib::Response &res,
+                                   CachedAsset &asset) {
+  res.status = asset.status;
+  res.headers.clear();
+  for (idx_t i = 0; i < asset.header_names.size(); i++) {
+    res.headers.emplace(asset.header_names[i], asset.header_values[i]);
   }
+  res.body = std::move(asset.body);
+}
 
-  // forward GET to remote URL
-  auto result = client.Get(req.path, req.params, headers);
-  if (!result) {
-    res.status = 500;
-    res.set_content("Could not fetch: '" + req.path + "' from '" + remote_url +
-                        "': " + to_string(result.error()),
-                    "text/plain");
-    return;
+// Assets marked immutable never change under the same URL (their names include
+// a hash of their content), so they can be served without revalidation.
+static bool IsImmutableAsset(const httplib::Response &res) {
+  auto cache_control = StringUtil::Lower(res.get_header_value("Cache-Control"));
+  return IsCacheableAsset(res) &&
+         StringUtil::Contains(cache_control, "immutable");
+}
+
+// Serves an asset from memory, in the variant matching the Accept-Encoding
+// header of the request.
+static void
+SetResponseMemoryCachedAsset(httplib::Response &res,
+                             shared_ptr<const MemoryCachedAsset> cached,
+                             ContentEncoding encoding) {
+  auto &asset = cached->asset;
+  auto &body = cached->GetBody(encoding);
+  auto body_data = body.data();
+  res.status = asset.status;
+  res.headers.clear();
+  for (idx_t i = 0; i < asset.header_names.size(); i++) {
+    // Set by the content provider.
+    if (!StringUtil::CIEquals(asset.header_names[i], "Content-Type")) {
+      res.headers.emplace(asset.header_names[i], asset.header_values[i]);
+    }
+  }
+  if (!cached->gzip_body.empty() || !cached->zstd_body.empty()) {
+    res.set_header("Vary", "Accept-Encoding");
+  }
+  if (encoding != ContentEncoding::NONE) {
+    res.set_header("Content-Encoding", ContentEncodingName(encoding));
+  }
+  // The entry is kept until the response is done, even if it is evicted.
+  res.set_content_provider(
+      body.size(), asset.GetHeader("Content-Type"),
+      [cached, body_data](size_t offset, size_t length,
+                          httplib::DataSink &sink) {
+        return sink.write(body_data + offset, length);
+      });
+}
+
+// Serves an asset from the bundle. Returns false if it isn't in the bundle.
+static bool SetResponseBundleAsset(const httplib::Request &req,
+                                   httplib::Response &res,
+                                   shared_ptr<AssetBundle> bundle) {
+  AssetBundle::Asset asset;
+  if (!bundle->Find(req.path, asset)) {
+    return false;
+  }
+
+  // Replacing the bundle changes the tags of all its assets.
+  auto etag = StringUtil::Format("\"%s-%llu\"", bundle->GetVersion(),
+                                 bundle->GetSizeBytes());
+  res.set_header("ETag", etag);
+  // Documents and extensionless resources (e.g. /config) are revalidated, so
+  // a new bundle is picked up. They refer to the other assets, which can be
+  // cached for good.
+  auto last_slash = req.path.rfind('/');
+  auto has_extension = req.path.find('.', last_slash) != std::string::npos;
+  if (asset.content_type == "text/html" || !has_extension) {
+    res.set_header("Cache-Control", "no-cache");
+  } else {
+    res.set_header("Cache-Control", "public, max-age=31536000, immutable");
+  }
+  if (req.get_header_value("If-None-Match") == etag) {
+    res.status = 304;
+    return true;
   }
 
-  // Repond with result of forwarded GET
-  res = result.value();
+  // Written straight from the mapping, which the bundle keeps until the
+  // response is done.
+  res.set_content_provider(
+      asset.size, asset.content_type,
+      [bundle, asset](size_t offset, size_t length, httplib::DataSink &sink) {
+        return sink.write(asset.data + offset, length);
+      });
+  return true;
+}
+
+void HttpServer::HandleGet(const httplib::Request &req,
+                           httplib::Response &res) {
+  shared_ptr<AssetBundle> bundle;
+  {
+    std::lock_guard<std::mutex> guard(asset_bundle_mutex);
+    bundle = asset_bundle;
+  }
+  if (bundle) {
+    // Offline mode: the remote URL isn't used at all.
+    if (!SetResponseBundleAsset(req, res, std::move(bundle))) {
+      res.status = 404;
+      res.set_content("Not found in the asset bundle: '" + req.path + "'",
+                      "text/plain");
+      return;
+    }
+  } else if (!ProxyRemoteAsset(req, res)) {
+    return;
+  }
 
   // If this is the config request, return additional information.
   if (req.path == "/config") {
@@ -314,6 +907,88 @@ void HttpServer::HandleGet(const httplib::Request &req,
   res.headers.erase("Content-Length");
 }
 
+bool HttpServer::ProxyRemoteAsset(const httplib::Request &req,
+                                  httplib::Response &res, bool prefetch) {
+  auto cache_key =
+      AssetCache::MakeKey(remote_url, req.path,
+                          httplib::detail::params_to_query_str(req.params));
+  // Immutable assets are kept in memory, and served without asking the remote
+  // URL.
+  if (asset_memory_cache) {
+    auto encoding =
+        NegotiateContentEncoding(req.get_header_value("Accept-Encoding"));
+    auto in_memory = asset_memory_cache->Get(cache_key, encoding);
+    if (in_memory) {
+      SetResponseMemoryCachedAsset(res, std::move(in_memory), encoding);
+      return true;
+    }
+  }
+
+  // Responses are cached on disk. A cached response is revalidated with the
+  // remote URL, and used if it is unchanged or can't be reached.
+  unique_ptr<CachedAsset> cached;
+  if (asset_cache) {
+    cached = asset_cache->Get(cache_key);
+  }
+
+  // Clients of the remote URL are kept alive and shared by the requests.
+  auto client = remote_client_pool->Acquire();
+
+  httplib::Headers headers = {{"User-Agent", user_agent}};
+  auto cookie = req.get_header_value("Cookie");
+  if (!cookie.empty()) {
+    headers.emplace("Cookie", cookie);
+  }
+  if (cached) {
+    auto etag = cached->GetHeader("ETag");
+    if (!etag.empty()) {
+      headers.emplace("If-None-Match", etag);
+    }
+    auto last_modified = cached->GetHeader("Last-Modified");
+    if (!last_modified.empty()) {
+      headers.emplace("If-Modified-Since", last_modified);
+    }
+  }
+
+  // forward GET to remote URL
+  // The pool hands out no clients once the server is stopping.
+  httplib::Result result(nullptr, httplib::Error::Canceled);
+  if (client) {
+    if (prefetch) {
+      client->set_connection_timeout(
+          MinValue<time_t>(PREFETCH_CONNECTION_TIMEOUT_S, http_params->timeout),
+          0);
+    }
+    result = client->Get(req.path, req.params, headers);
+    if (prefetch) {
+      // Other requests wait as long as http_timeout says.
+      InitClientFromParams(*client);
+    }
+    // A client whose request failed has closed its connection, and opens a
+    // new one for its next request, so it can be reused either way.
+    remote_client_pool->Release(std::move(client));
+  }
+  if (cached && (!result || result->status == 304 || result->status >= 500)) {
+    SetResponseCachedAsset(res, *cached);
+  } else if (!result) {
+    res.status = 500;
+    res.set_content("Could not fetch: '" + req.path + "' from '" + remote_url +
+                        "': " + to_string(result.error()),
+                    "text/plain");
+    return false;
+  } else {
+    // Repond with result of forwarded GET
+    res = result.value();
+    if (asset_cache && IsCacheableAsset(res)) {
+      asset_cache->Put(MakeCachedAsset(cache_key, res));
+    }
+  }
+  if (asset_memory_cache && IsImmutableAsset(res)) {
+    asset_memory_cache->Put(MakeCachedAsset(cache_key, res));
+  }
+  return true;
+}
+
 void HttpServer::HandleInterrupt(const httplib::Request &req,
                                  httplib::Response &res) {
   auto origin = req.get_header_value("Origin");
@@ -340,6 +1015,22 @@ void HttpServer::HandleInterrupt(const httplib::Request &req,
   }
 
   connection->Interrupt();
+  // Requests still waiting for their turn are dropped too.
+  if (run_scheduler) {
+    run_scheduler->CancelQueued(connection_name);
+  }
+
+  // Wake the requests waiting for tasks of the connection, so the interrupted
+  // run stops promptly.
+  {
+    std::lock_guard<std::mutex> guard(task_waiters_mutex);
+    auto range = task_waiters.equal_range(connection.get());
+    for (auto it = range.first; it != range.second; ++it) {
+      std::lock_guard<std::mutex> waiter_guard(it->second->mutex);
+      it->second->interrupted = true;
+      it->second->cv.notify_all();
+    }
+  }
 
   SetResponseEmptyResult(res);
 }
@@ -371,7 +1062,9 @@ void HttpServer::DoHandleRun(const httplib::Request &req,
   auto schema_name_option =
       DecodeBase64(req.get_header_value("X-DuckDB-UI-Schema-Name"));
 
-  std::vector<std::string> parameter_values;
+  // Parameters passed in headers are always strings. Typed parameters can be
+  // passed in a binary request body instead (see below).
+  vector<Value> parameters;
   auto parameter_count_string =
       req.get_header_value("X-DuckDB-UI-Parameter-Count");
   if (!parameter_count_string.empty()) {
@@ -379,10 +1072,14 @@ void HttpServer::DoHandleRun(const httplib::Request &req,
     for (idx_t i = 0; i < parameter_count; ++i) {
       auto parameter_value = DecodeBase64(req.get_header_value(
           StringUtil::Format("X-DuckDB-UI-Parameter-Value-%d", i)));
-      parameter_values.push_back(parameter_value);
+      parameters.push_back(Value(parameter_value));
     }
   }
 
+  // If set to "binary", the request body is a serialized RunRequest holding
+  // the SQL text and its typed parameters, instead of just the SQL text.
+  auto request_format = req.get_header_value("X-DuckDB-UI-Request-Format");
+
   // default to effectively no limit
   auto result_row_limit = INT_MAX;
   auto result_row_limit_string =
@@ -391,6 +1088,13 @@ void HttpServer::DoHandleRun(const httplib::Request &req,
     result_row_limit = std::stoi(result_row_limit_string);
   }
 
+  optional_idx request_batch_size;
+  if (!ReadRequestBatchSize(req, request_batch_size)) {
+    res.status = 400;
+    SetResponseErrorResult(res, "Invalid X-DuckDB-UI-Result-Batch-Size");
+    return;
+  }
+
   auto result_database_name_option =
       DecodeBase64(req.get_header_value("X-DuckDB-UI-Result-Database-Name"));
   auto result_schema_name_option =
@@ -411,8 +1115,106 @@ void HttpServer::DoHandleRun(const httplib::Request &req,
   auto errors_as_json_string =
       req.get_header_value("X-DuckDB-UI-Errors-As-JSON");
 
+  auto serialization_version = GetSerializationVersion(req);
+
+  // If set, chunks are written to the response as soon as they are fetched,
+  // instead of after the whole result has been read.
+  auto stream_result =
+      req.get_header_value("X-DuckDB-UI-Stream-Result") == "true";
+
+  // If set to "arrow", the result is returned as an Arrow IPC stream, instead
+  // of a serialized SuccessResult. Errors are still returned as ErrorResults.
+  auto result_format = req.get_header_value("X-DuckDB-UI-Result-Format");
+  auto arrow_result = result_format == "arrow";
+  if (!arrow_result && !result_format.empty()) {
+    SetResponseErrorResult(
+        res,
+        StringUtil::Format("Unsupported result format: %s", result_format));
+    return;
+  }
+
+  // If set, the result is kept open after the response, and the rows beyond
+  // the result row limit can be fetched later using /ddb/fetch.
+  auto result_cursor =
+      req.get_header_value("X-DuckDB-UI-Result-Cursor") == "true";
+  if (result_cursor) {
+    if (connection_name.empty()) {
+      SetResponseErrorResult(res, "Result cursors require a connection name");
+      return;
+    }
+    if (stream_result || arrow_result || !result_table_name.empty()) {
+      SetResponseErrorResult(res, "Result cursors cannot be combined with "
+                                  "streamed or Arrow results or result tables");
+      return;
+    }
+  }
+
+  // If set to "script", all statements run to completion without keeping
+  // their results, stopping at the first error. The response is a ScriptResult
+  // with the timing and row count of each statement.
+  auto run_mode = req.get_header_value("X-DuckDB-UI-Run-Mode");
+  auto script_mode = run_mode == "script";
+  if (!script_mode && !run_mode.empty()) {
+    SetResponseErrorResult(
+        res, StringUtil::Format("Unsupported run mode: %s", run_mode));
+    return;
+  }
+
+  // If set, the response holds a uniform random sample of the whole result,
+  // with as many rows as the result row limit, instead of its first rows. A
+  // seed can be given to make the sample reproducible.
+  auto result_sample =
+      req.get_header_value("X-DuckDB-UI-Result-Sample") == "true";
+  int64_t result_sample_seed = -1;
+  auto result_sample_seed_string =
+      req.get_header_value("X-DuckDB-UI-Result-Sample-Seed");
+  if (!result_sample_seed_string.empty()) {
+    result_sample_seed = std::stoll(result_sample_seed_string);
+  }
+  if (result_sample && (stream_result || arrow_result || result_cursor)) {
+    SetResponseErrorResult(res, "Sampled results cannot be combined with "
+                                "streamed or Arrow results or result cursors");
+    return;
+  }
+
+  // If set, the response includes a profile of each column, computed from the
+  // rows in the response.
+  auto result_profile =
+      req.get_header_value("X-DuckDB-UI-Result-Profile") == "true";
+  if (result_profile && (stream_result || arrow_result)) {
+    SetResponseErrorResult(res, "Column profiles cannot be combined with "
+                                "streamed or Arrow results");
+    return;
+  }
+
+  // If set, the result may be served from (and is stored in) the result cache.
+  // Only the results of single SELECT statements are cached.
+  auto use_result_cache =
+      req.get_header_value("X-DuckDB-UI-Result-Cache") == "true" &&
+      !stream_result && !arrow_result && !result_cursor && !result_profile &&
+      !result_sample && !script_mode && result_table_name.empty();
+
   std::string content = ReadContent(content_reader);
 
+  if (request_format == "binary") {
+    auto run_request = ReadRunRequest(content);
+    content = std::move(run_request->sql);
+    parameters = std::move(run_request->parameters);
+  } else if (!request_format.empty()) {
+    SetResponseErrorResult(
+        res, StringUtil::Format("Unsupported request format: %s",
+                                request_format));
+    return;
+  }
+
+  if (script_mode &&
+      (!parameters.empty() || stream_result || arrow_result || result_cursor ||
+       result_sample || result_profile || !result_table_name.empty())) {
+    SetResponseErrorResult(res, "Scripts cannot have parameters or result "
+                                "options");
+    return;
+  }
+
   auto db = ddb_instance.lock();
   if (!db) {
     SetResponseErrorResult(
@@ -420,17 +1222,65 @@ void HttpServer::DoHandleRun(const httplib::Request &req,
     return;
   }
 
-  auto connection =
-      UIStorageExtensionInfo::GetState(*db).FindOrCreateConnection(
-          *db, connection_name);
+  // Wait for a turn to run. Rejected requests get a 503, so the client knows
+  // it can retry.
+  std::string admission_error;
+  auto ticket = shared_ptr<RunScheduler::Ticket>(run_scheduler->Admit(
+      connection_name,
+      RunScheduler::GetPriority(
+          req.get_header_value("X-DuckDB-UI-Request-Priority"), description),
+      admission_error));
+  if (!ticket) {
+    res.status = 503;
+    res.set_header("Retry-After", "1");
+    SetResponseErrorResult(res, admission_error);
+    return;
+  }
+
+  // Queries are interrupted if the client goes away (e.g. the tab is closed or
+  // the fetch is aborted), so abandoned queries don't keep running.
+  auto is_client_gone = MakeClientGoneCheck();
+
+  auto &state = UIStorageExtensionInfo::GetState(*db);
+  auto connection = state.FindOrCreateConnection(*db, connection_name);
   auto &context = *connection->context;
   auto &config = ClientConfig::GetConfig(context);
 
+  // Running a query invalidates the previous result on the connection.
+  state.CloseCursor(connection_name);
+  StopMaterializers(connection_name);
+
   // Set errors_as_json
   if (!errors_as_json_string.empty()) {
     config.errors_as_json = errors_as_json_string == "true";
   }
 
+  // DuckDB only tracks the progress of queries with the progress bar enabled.
+  // It is enabled (but not printed) for the queries of this request only:
+  // queries started later on the connection get the settings it had before.
+  auto report_progress =
+      MakeQueryProgressReporter(connection_name, *connection);
+  struct ProgressBarRestorer {
+    ClientConfig *config = nullptr;
+    bool enable_progress_bar = false;
+    bool print_progress_bar = false;
+    ~ProgressBarRestorer() {
+      // Unless the queries changed them.
+      if (config && config->enable_progress_bar &&
+          !config->print_progress_bar) {
+        config->enable_progress_bar = enable_progress_bar;
+        config->print_progress_bar = print_progress_bar;
+      }
+    }
+  } progress_bar_restorer;
+  if (GetQueryProgressInterval(context) > 0) {
+    progress_bar_restorer.config = &config;
+    progress_bar_restorer.enable_progress_bar = config.enable_progress_bar;
+    progress_bar_restorer.print_progress_bar = config.print_progress_bar;
+    config.enable_progress_bar = true;
+    config.print_progress_bar = false;
+  }
+
   // Set current database & schema
   if (!database_name_option.empty() || !schema_name_option.empty()) {
     // It's fine if the database name is empty, but we need a valid schema name.
@@ -459,6 +1309,70 @@ void HttpServer::DoHandleRun(const httplib::Request &req,
     return;
   }
 
+  // Statements other than SELECT can change the settings, search path or
+  // temporary tables of the connection, which cached results depend on but
+  // aren't part of the data state. Drop all cached results once such
+  // statements have run.
+  auto read_only = true;
+  for (auto &statement : statements) {
+    read_only = read_only && statement->type == StatementType::SELECT_STATEMENT;
+  }
+  struct ResultCacheClearer {
+    ResultCache *cache = nullptr;
+    ~ResultCacheClearer() {
+      if (cache) {
+        cache->Clear();
+      }
+    }
+  } result_cache_clearer;
+  if (!read_only) {
+    result_cache_clearer.cache = result_cache.get();
+  }
+  use_result_cache = use_result_cache && read_only && statement_count == 1;
+
+  // Cached results are keyed on the search path in effect, which the database
+  // and schema names of this or earlier requests set on the connection.
+  std::string result_cache_key;
+  idx_t result_cache_generation = 0;
+  DataState data_state;
+  if (use_result_cache) {
+    auto &search_path = *ClientData::Get(context).catalog_search_path;
+    auto batch_size = serialization_version >= 3
+                          ? GetBatchSize(request_batch_size, context)
+                          : STANDARD_VECTOR_SIZE;
+    result_cache_key = ResultCache::MakeKey(
+        connection_name, content, parameters,
+        CatalogSearchEntry::ListToString(search_path.Get()), result_row_limit,
+        batch_size, serialization_version);
+    // Read the generation before the data state and the query, so a write
+    // finishing in between prevents storing the result.
+    result_cache_generation = result_cache->GetGeneration();
+    Connection catalog_connection(*db);
+    use_result_cache = GetDataState(*db, catalog_connection, data_state);
+  }
+  if (use_result_cache) {
+    std::string result_bytes;
+    if (result_cache->Get(result_cache_key, data_state, result_bytes)) {
+      res.body = std::move(result_bytes);
+      res.set_header("Content-Type", "application/octet-stream");
+      return;
+    }
+    use_result_cache = result_cache->IsCacheable(
+        *connection, content, result_cache_key, data_state.catalog_state);
+  }
+
+  if (script_mode) {
+    ScriptResult script_result;
+    RunScript(*connection, statements, script_result, is_client_gone,
+              report_progress);
+    if (is_client_gone()) {
+      run_scheduler->RecordAborted();
+      return;
+    }
+    SetResponseResult(res, script_result);
+    return;
+  }
+
   // If there's more than one statement, run all but the last.
   if (statement_count > 1) {
     for (auto i = 0; i < statement_count - 1; ++i) {
@@ -469,17 +1383,15 @@ void HttpServer::DoHandleRun(const httplib::Request &req,
         return;
       }
       // Execute tasks until result is ready (or there's an error).
-      auto exec_result = PendingExecutionResult::RESULT_NOT_READY;
-      while (!PendingQueryResult::IsResultReady(exec_result)) {
-        exec_result = pending->ExecuteTask();
-        if (exec_result == PendingExecutionResult::BLOCKED ||
-            exec_result == PendingExecutionResult::NO_TASKS_AVAILABLE) {
-          std::this_thread::sleep_for(std::chrono::milliseconds(1));
-        }
-      }
+      auto exec_result = ExecuteTasks(*connection, *pending, is_client_gone,
+                                      report_progress);
       // Return any error found during execution.
       switch (exec_result) {
       case PendingExecutionResult::EXECUTION_ERROR:
+        if (is_client_gone()) {
+          run_scheduler->RecordAborted();
+          return;
+        }
         SetResponseErrorResult(res, pending->GetError());
         return;
       case PendingExecutionResult::EXECUTION_FINISHED:
@@ -504,19 +1416,36 @@ void HttpServer::DoHandleRun(const httplib::Request &req,
   unique_ptr<PendingQueryResult> pending;
 
   // Create pending query, with request content as SQL.
-  if (parameter_values.size() > 0) {
-    auto prepared = connection->Prepare(std::move(statement_to_run));
-    if (prepared->HasError()) {
-      SetResponseErrorResult(res, prepared->GetError());
-      return;
+  if (parameters.size() > 0) {
+    // Reuse the statement if the same SQL was prepared on this connection
+    // before, so only binding the parameters and executing remain.
+    auto statement_cache = state.GetPreparedStatementCache(connection_name);
+    std::string statement_key;
+    CatalogState statement_catalog_state;
+    shared_ptr<PreparedStatement> prepared;
+    if (statement_cache) {
+      auto &search_path = *ClientData::Get(context).catalog_search_path;
+      statement_key = PreparedStatementCache::MakeKey(
+          content, CatalogSearchEntry::ListToString(search_path.Get()));
+      Connection catalog_connection(*db);
+      statement_catalog_state = GetCatalogState(*db, catalog_connection);
+      prepared = statement_cache->Get(statement_key, statement_catalog_state);
     }
 
-    vector<Value> values;
-    for (auto &parameter_value : parameter_values) {
-      // TODO: support non-string parameters?
-      values.push_back(Value(parameter_value));
+    if (!prepared) {
+      prepared = shared_ptr<PreparedStatement>(
+          connection->Prepare(std::move(statement_to_run)));
+      if (prepared->HasError()) {
+        SetResponseErrorResult(res, prepared->GetError());
+        return;
+      }
+      if (statement_cache) {
+        statement_cache->Put(statement_key, std::move(statement_catalog_state),
+                             prepared);
+      }
     }
-    pending = prepared->PendingQuery(values, true);
+
+    pending = prepared->PendingQuery(parameters, true);
   } else {
     pending = connection->PendingQuery(std::move(statement_to_run), true);
   }
@@ -527,31 +1456,32 @@ void HttpServer::DoHandleRun(const httplib::Request &req,
   }
 
   // Execute tasks until result is ready (or there's an error).
-  auto exec_result = PendingExecutionResult::RESULT_NOT_READY;
-  while (!PendingQueryResult::IsResultReady(exec_result)) {
-    exec_result = pending->ExecuteTask();
-    if (exec_result == PendingExecutionResult::BLOCKED ||
-        exec_result == PendingExecutionResult::NO_TASKS_AVAILABLE) {
-      std::this_thread::sleep_for(std::chrono::milliseconds(1));
-    }
-  }
+  auto exec_result =
+      ExecuteTasks(*connection, *pending, is_client_gone, report_progress);
 
   switch (exec_result) {
 
   case PendingExecutionResult::EXECUTION_ERROR:
+    if (is_client_gone()) {
+      run_scheduler->RecordAborted();
+      break;
+    }
     SetResponseErrorResult(res, pending->GetError());
     break;
 
   case PendingExecutionResult::EXECUTION_FINISHED:
   case PendingExecutionResult::RESULT_READY: {
     // Get the result. This should be quick because it's ready.
-    auto result = pending->Execute();
-
-    // We use a separate connection for the appender, including creating the
-    // result table, because we still need to fetch chunks from the pending
-    // query on the user's connection.
-    unique_ptr<duckdb::Connection> appender_connection;
-    unique_ptr<duckdb::Appender> appender;
+    auto reader = make_shared_ptr<ResultReader>(
+        connection, pending->Execute(), result_row_limit,
+        result_table_row_limit);
+    reader->SetCompressVectors(serialization_version >= 2);
+    if (serialization_version >= 3 || arrow_result) {
+      reader->SetBatchSize(
+          GetBatchSize(request_batch_size, *connection->context));
+    }
+    // The first rows of a streamed result are sent as soon as they are read.
+    reader->SetBatchFirstChunk(!stream_result);
 
     if (!result_table_name.empty()) {
       auto result_database_name = result_database_name_option.empty()
@@ -560,77 +1490,143 @@ void HttpServer::DoHandleRun(const httplib::Request &req,
       auto result_schema_name = result_schema_name_option.empty()
                                     ? "main"
                                     : result_schema_name_option;
+      reader->CreateResultTable(*db, result_database_name, result_schema_name,
+                                result_table_name);
+      TrackResultTable(GetResultTableKey(result_database_name,
+                                         result_schema_name, result_table_name),
+                       reader);
+    }
 
-      auto result_table_info = make_uniq<duckdb::CreateTableInfo>(
-          result_database_name, result_schema_name, result_table_name);
-      for (idx_t i = 0; i < result->names.size(); i++) {
-        result_table_info->columns.AddColumn(
-            ColumnDefinition(result->names[i], result->types[i]));
-      }
+    // Size of the rows a buffered response may hold in memory.
+    auto memory_budget = GetResultMemoryBudget(context);
 
-      appender_connection = make_uniq<duckdb::Connection>(*db);
-      auto appender_context = appender_connection->context;
-      appender_context->RunFunctionInTransaction([&] {
-        auto &catalog = duckdb::Catalog::GetCatalog(*appender_context,
-                                                    result_database_name);
-        MetaTransaction::Get(*appender_context)
-            .ModifyDatabase(catalog.GetAttached());
-        catalog.CreateTable(*appender_context, std::move(result_table_info));
-      });
+    shared_ptr<ArrowIPCWriter> arrow_writer;
+    if (arrow_result) {
+      arrow_writer = make_shared_ptr<ArrowIPCWriter>(
+          connection->context, reader->GetColumnNamesAndTypes());
+    }
 
-      appender = make_uniq<duckdb::Appender>(
-          *appender_connection, result_database_name, result_schema_name,
-          result_table_name);
+    if (stream_result) {
+      SetResponseStreamedResult(req, res, connection_name, std::move(reader),
+                                std::move(arrow_writer), std::move(ticket));
+      break;
     }
 
-    // Fetch the chunks and serialize the result.
-    SuccessResult success_result;
-    success_result.column_names_and_types = {std::move(result->names),
-                                             std::move(result->types)};
-
-    auto row_limit = std::max(result_row_limit, result_table_row_limit);
-    auto rows_fetched = 0;
-    auto rows_appended = 0;
-    auto rows_in_result = 0;
-    unique_ptr<duckdb::DataChunk> chunk;
-    while (rows_fetched < row_limit) {
-      chunk = result->Fetch();
-      if (!chunk) {
+    if (arrow_writer) {
+      std::string arrow_content;
+      arrow_writer->WriteSchema(arrow_content);
+      Chunk chunk;
+      auto over_budget = false;
+      while (reader->ReadChunk(chunk)) {
+        if (is_client_gone()) {
+          reader->Abort();
+          run_scheduler->RecordAborted();
+          return;
+        }
+        // Streaming results keep executing while they are fetched.
+        report_progress();
+        arrow_writer->WriteRecordBatch(chunk, arrow_content);
+        if (arrow_content.size() > memory_budget) {
+          over_budget = true;
+          break;
+        }
+      }
+      if (over_budget) {
+        // A streamed Arrow response is the same as a buffered one, so send
+        // the rest as it is read.
+        SetResponseStreamedResult(req, res, connection_name, std::move(reader),
+                                  std::move(arrow_writer), std::move(ticket),
+                                  std::move(arrow_content));
         break;
       }
-      rows_fetched += chunk->size();
-      if (appender && rows_appended < result_table_row_limit) {
-        duckdb::DataChunk *chunk_to_append = chunk.get();
-        duckdb::DataChunk chunk_prefix;
-        auto rows_left = result_table_row_limit - rows_appended;
-        if (chunk->size() > rows_left) {
-          HttpServer::CopyAndSlice(*chunk, chunk_prefix, rows_left);
-          chunk_to_append = &chunk_prefix;
+      ReleaseResult(connection_name, std::move(reader));
+      ArrowIPCWriter::WriteEndOfStream(arrow_content);
+      res.body = std::move(arrow_content);
+      res.set_header("Content-Type", ARROW_STREAM_CONTENT_TYPE);
+      break;
+    }
+
+    // Fetch the chunks and serialize the result. Once the chunks held in
+    // memory exceed the budget, they and the rest of the result are moved to
+    // a SpilledResult.
+    SuccessResult success_result;
+    success_result.column_names_and_types = reader->GetColumnNamesAndTypes();
+    shared_ptr<SpilledResult> spilled_result;
+
+    unique_ptr<ColumnProfiler> profiler;
+    if (result_profile) {
+      profiler = make_uniq<ColumnProfiler>(
+          success_result.column_names_and_types.types);
+    }
+
+    if (result_sample) {
+      ReservoirSampler sampler(success_result.column_names_and_types.types,
+                               result_row_limit, result_sample_seed,
+                               memory_budget);
+      if (!reader->ReadSample(sampler, is_client_gone)) {
+        reader->Abort();
+        run_scheduler->RecordAborted();
+        return;
+      }
+      success_result.chunks = sampler.GetChunks();
+      if (profiler) {
+        for (auto &chunk : success_result.chunks) {
+          profiler->Update(chunk);
         }
-        appender->AppendDataChunk(*chunk_to_append);
-        rows_appended += chunk_to_append->size();
       }
-      if (rows_in_result < result_row_limit) {
-        duckdb::DataChunk *chunk_to_add = chunk.get();
-        duckdb::DataChunk chunk_prefix;
-        auto rows_left = result_row_limit - rows_in_result;
-        if (chunk->size() > rows_left) {
-          HttpServer::CopyAndSlice(*chunk, chunk_prefix, rows_left);
-          chunk_to_add = &chunk_prefix;
+    } else {
+      Chunk chunk;
+      idx_t buffered_size = 0;
+      while (reader->ReadChunk(chunk)) {
+        if (is_client_gone()) {
+          reader->Abort();
+          run_scheduler->RecordAborted();
+          return;
+        }
+        report_progress();
+        // Once spilled, the profiler belongs to the SpilledResult, which
+        // updates it as chunks are appended.
+        if (spilled_result) {
+          spilled_result->Append(chunk);
+          continue;
+        }
+        if (profiler) {
+          profiler->Update(chunk);
+        }
+        buffered_size += chunk.GetAllocationSize();
+        success_result.chunks.push_back(std::move(chunk));
+        if (buffered_size > memory_budget) {
+          spilled_result = make_shared_ptr<SpilledResult>(
+              context, std::move(success_result), std::move(profiler));
         }
-        success_result.chunks.push_back(
-            {static_cast<uint16_t>(chunk_to_add->size()), std::move(chunk_to_add->data)});
-        rows_in_result += chunk_to_add->size();
       }
     }
+    if (profiler) {
+      success_result.column_profiles = profiler->Finish(success_result.chunks);
+    }
 
-    if (appender) {
-      appender->Close();
+    std::string cursor_id;
+    if (result_cursor && !reader->IsExhausted()) {
+      cursor_id = UUID::ToString(UUID::GenerateRandomUUID());
+      state.PutCursor(connection_name, cursor_id, std::move(reader),
+                      std::chrono::milliseconds(GetCursorIdleTimeout(context)));
+    } else {
+      ReleaseResult(connection_name, std::move(reader));
     }
 
-    MemoryStream success_response_content;
-    BinarySerializer::Serialize(success_result, success_response_content);
-    SetResponseContent(res, success_response_content);
+    if (spilled_result) {
+      // Too large to cache.
+      spilled_result->SetCursorId(cursor_id);
+      SetResponseSpilledResult(req, res, std::move(spilled_result));
+      break;
+    }
+    success_result.cursor_id = cursor_id;
+    SetResponseResult(res, success_result);
+
+    if (use_result_cache) {
+      result_cache->Put(result_cache_key, result_cache_generation,
+                        std::move(data_state), res.body);
+    }
     break;
   }
   default:
@@ -641,6 +1637,465 @@ void HttpServer::DoHandleRun(const httplib::Request &req,
   }
 }
 
+void HttpServer::HandleFetch(const httplib::Request &req,
+                             httplib::Response &res) {
+  try {
+    DoHandleFetch(req, res);
+  } catch (const std::exception &ex) {
+    SetResponseErrorResult(res, ex.what());
+  }
+}
+
+void HttpServer::DoHandleFetch(const httplib::Request &req,
+                               httplib::Response &res) {
+  auto origin = req.get_header_value("Origin");
+  if (origin != local_url) {
+    res.status = 401;
+    return;
+  }
+
+  auto description = req.get_header_value("X-DuckDB-UI-Request-Description");
+
+  auto connection_name = req.get_header_value("X-DuckDB-UI-Connection-Name");
+
+  auto cursor_id = req.get_header_value("X-DuckDB-UI-Cursor-Id");
+
+  // default to effectively no limit
+  auto result_row_limit = INT_MAX;
+  auto result_row_limit_string =
+      req.get_header_value("X-DuckDB-UI-Result-Row-Limit");
+  if (!result_row_limit_string.empty()) {
+    result_row_limit = std::stoi(result_row_limit_string);
+  }
+
+  auto db = ddb_instance.lock();
+  if (!db) {
+    SetResponseErrorResult(
+        res, "Database was invalidated, UI needs to be restarted");
+    return;
+  }
+
+  // Fetching runs the rest of the query, so it is admitted like a run. The
+  // ticket holds the slot of the connection while the cursor is drained:
+  // a run on the connection waits for it, instead of closing the cursor and
+  // using the connection at the same time.
+  std::string admission_error;
+  auto ticket = run_scheduler->Admit(
+      connection_name,
+      RunScheduler::GetPriority(
+          req.get_header_value("X-DuckDB-UI-Request-Priority"), description),
+      admission_error);
+  if (!ticket) {
+    res.status = 503;
+    res.set_header("Retry-After", "1");
+    SetResponseErrorResult(res, admission_error);
+    return;
+  }
+
+  // The cursor is taken out while fetching, so concurrent fetches using the
+  // same cursor can't interfere.
+  auto &state = UIStorageExtensionInfo::GetState(*db);
+  auto reader = state.TakeCursor(connection_name, cursor_id);
+  auto connection = state.FindConnection(connection_name);
+  if (!reader || !connection) {
+    SetResponseErrorResult(res, "Result cursor not found or expired");
+    return;
+  }
+
+  auto is_client_gone = MakeClientGoneCheck();
+  auto report_progress =
+      MakeQueryProgressReporter(connection_name, *connection);
+
+  SuccessResult success_result;
+  success_result.column_names_and_types = reader->GetColumnNamesAndTypes();
+
+  reader->ResetRowLimit(result_row_limit);
+  Chunk chunk;
+  while (reader->ReadChunk(chunk)) {
+    if (is_client_gone()) {
+      // The rest of the result won't be fetched either.
+      reader->Abort();
+      run_scheduler->RecordAborted();
+      return;
+    }
+    report_progress();
+    success_result.chunks.push_back(std::move(chunk));
+  }
+
+  if (!reader->IsExhausted()) {
+    success_result.cursor_id = cursor_id;
+    state.PutCursor(
+        connection_name, cursor_id, std::move(reader),
+        std::chrono::milliseconds(GetCursorIdleTimeout(*connection->context)));
+  }
+  if (reader) {
+    reader->Close();
+  }
+
+  SetResponseResult(res, success_result);
+}
+
+void HttpServer::HandleReadResultTable(const httplib::Request &req,
+                                       httplib::Response &res) {
+  try {
+    DoHandleReadResultTable(req, res);
+  } catch (const std::exception &ex) {
+    SetResponseErrorResult(res, ex.what());
+  }
+}
+
+void HttpServer::DoHandleReadResultTable(const httplib::Request &req,
+                                         httplib::Response &res) {
+  auto origin = req.get_header_value("Origin");
+  if (origin != local_url) {
+    res.status = 401;
+    return;
+  }
+
+  auto description = req.get_header_value("X-DuckDB-UI-Request-Description");
+
+  auto result_database_name_option =
+      DecodeBase64(req.get_header_value("X-DuckDB-UI-Result-Database-Name"));
+  auto result_schema_name_option =
+      DecodeBase64(req.get_header_value("X-DuckDB-UI-Result-Schema-Name"));
+  auto result_table_name =
+      DecodeBase64(req.get_header_value("X-DuckDB-UI-Result-Table-Name"));
+  if (result_table_name.empty()) {
+    SetResponseErrorResult(res, "No result table name");
+    return;
+  }
+  auto result_database_name = result_database_name_option.empty()
+                                  ? "memory"
+                                  : result_database_name_option;
+  auto result_schema_name =
+      result_schema_name_option.empty() ? "main" : result_schema_name_option;
+
+  // Comma-separated indexes of the columns to read. Defaults to all columns.
+  auto result_columns_string =
+      req.get_header_value("X-DuckDB-UI-Result-Columns");
+
+  // Position of the first row to read.
+  idx_t result_row_offset = 0;
+  auto result_row_offset_string =
+      req.get_header_value("X-DuckDB-UI-Result-Row-Offset");
+  if (!result_row_offset_string.empty()) {
+    result_row_offset = std::stoull(result_row_offset_string);
+  }
+
+  // default to effectively no limit
+  auto result_row_limit = INT_MAX;
+  auto result_row_limit_string =
+      req.get_header_value("X-DuckDB-UI-Result-Row-Limit");
+  if (!result_row_limit_string.empty()) {
+    result_row_limit = std::stoi(result_row_limit_string);
+  }
+
+  optional_idx request_batch_size;
+  if (!ReadRequestBatchSize(req, request_batch_size)) {
+    res.status = 400;
+    SetResponseErrorResult(res, "Invalid X-DuckDB-UI-Result-Batch-Size");
+    return;
+  }
+
+  auto db = ddb_instance.lock();
+  if (!db) {
+    SetResponseErrorResult(
+        res, "Database was invalidated, UI needs to be restarted");
+    return;
+  }
+
+  // Use a separate connection, so the results and cursors of the connection
+  // that filled the table are not affected.
+  auto connection = make_shared_ptr<Connection>(*db);
+  auto table = connection->TableInfo(result_database_name, result_schema_name,
+                                     result_table_name);
+  if (!table) {
+    SetResponseErrorResult(
+        res, StringUtil::Format("Result table not found: %s",
+                                result_table_name));
+    return;
+  }
+
+  vector<std::string> column_names;
+  if (result_columns_string.empty()) {
+    for (auto &column : table->columns) {
+      column_names.push_back(column.Name());
+    }
+  } else {
+    for (auto &index_string : StringUtil::Split(result_columns_string, ',')) {
+      auto index = std::stoull(index_string);
+      if (index >= table->columns.size()) {
+        SetResponseErrorResult(
+            res, StringUtil::Format("Result column index out of range: %s",
+                                    index_string));
+        return;
+      }
+      column_names.push_back(table->columns[index].Name());
+    }
+  }
+
+  // Result tables are only appended to, so their row ids are the positions of
+  // their rows. Filtering on them lets the scan skip the rows before the
+  // window, instead of reading and discarding them.
+  std::string sql = "SELECT ";
+  for (idx_t i = 0; i < column_names.size(); i++) {
+    if (i > 0) {
+      sql += ", ";
+    }
+    sql += KeywordHelper::WriteOptionallyQuoted(column_names[i]);
+  }
+  sql += StringUtil::Format(
+      " FROM %s.%s.%s WHERE rowid >= $1 AND rowid < $2 ORDER BY rowid",
+      KeywordHelper::WriteOptionallyQuoted(result_database_name),
+      KeywordHelper::WriteOptionallyQuoted(result_schema_name),
+      KeywordHelper::WriteOptionallyQuoted(result_table_name));
+
+  // The table may still be filling, in the background or while the response
+  // of its query is streamed, so a window may come back short. The response
+  // tells how many rows the table held when read, and whether more are
+  // coming. Checked before reading, so all rows of a complete table are
+  // visible to the transaction below.
+  auto result_table_complete = !IsFillingResultTable(GetResultTableKey(
+      result_database_name, result_schema_name, result_table_name));
+  // Unless committed, the transaction is rolled back with the connection.
+  connection->BeginTransaction();
+  auto count_result = connection->Query(StringUtil::Format(
+      "SELECT count(*) FROM %s.%s.%s",
+      KeywordHelper::WriteOptionallyQuoted(result_database_name),
+      KeywordHelper::WriteOptionallyQuoted(result_schema_name),
+      KeywordHelper::WriteOptionallyQuoted(result_table_name)));
+  if (count_result->HasError()) {
+    SetResponseErrorResult(res, count_result->GetError());
+    return;
+  }
+  auto result_table_row_count =
+      count_result->GetValue(0, 0).GetValue<int64_t>();
+
+  auto prepared = connection->Prepare(sql);
+  if (prepared->HasError()) {
+    SetResponseErrorResult(res, prepared->GetError());
+    return;
+  }
+  vector<Value> parameters{
+      Value::UBIGINT(result_row_offset),
+      Value::UBIGINT(result_row_offset + NumericCast<idx_t>(result_row_limit))};
+  auto result = prepared->Execute(parameters, false);
+  if (result->HasError()) {
+    SetResponseErrorResult(res, result->GetError());
+    return;
+  }
+  connection->Commit();
+
+  ResultReader reader(connection, std::move(result), result_row_limit, 0);
+  auto serialization_version = GetSerializationVersion(req);
+  reader.SetCompressVectors(serialization_version >= 2);
+  if (serialization_version >= 3) {
+    reader.SetBatchSize(GetBatchSize(request_batch_size, *connection->context));
+  }
+  SuccessResult success_result;
+  success_result.column_names_and_types = reader.GetColumnNamesAndTypes();
+  Chunk chunk;
+  while (reader.ReadChunk(chunk)) {
+    success_result.chunks.push_back(std::move(chunk));
+  }
+  reader.Close();
+
+  SetResponseResult(res, success_result);
+  res.set_header("X-DuckDB-UI-Result-Table-Row-Count",
+                 std::to_string(result_table_row_count));
+  res.set_header("X-DuckDB-UI-Result-Table-Complete",
+                 result_table_complete ? "true" : "false");
+}
+
+void HttpServer::RunScript(Connection &connection,
+                           vector<unique_ptr<SQLStatement>> &statements,
+                           ScriptResult &script_result,
+                           const std::function<bool()> &is_client_gone,
+                           const std::function<void()> &report_progress) {
+  for (auto &statement : statements) {
+    ScriptStatementResult statement_result;
+    statement_result.statement_type = StatementTypeToString(statement->type);
+    auto start = std::chrono::steady_clock::now();
+    try {
+      RunScriptStatement(connection, std::move(statement), statement_result,
+                         is_client_gone, report_progress);
+    } catch (std::exception &ex) {
+      ErrorData error(ex);
+      statement_result.error = error.RawMessage();
+    }
+    statement_result.elapsed_microseconds =
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start)
+            .count();
+
+    auto error = statement_result.error;
+    script_result.statements.push_back(std::move(statement_result));
+    if (!error.empty()) {
+      script_result.error = std::move(error);
+      return;
+    }
+  }
+}
+
+void HttpServer::RunScriptStatement(
+    Connection &connection, unique_ptr<SQLStatement> statement,
+    ScriptStatementResult &statement_result,
+    const std::function<bool()> &is_client_gone,
+    const std::function<void()> &report_progress) {
+  auto pending = connection.PendingQuery(std::move(statement), true);
+  if (pending->HasError()) {
+    statement_result.error = pending->GetError();
+    return;
+  }
+  if (ExecuteTasks(connection, *pending, is_client_gone, report_progress) ==
+      PendingExecutionResult::EXECUTION_ERROR) {
+    statement_result.error = pending->GetError();
+    return;
+  }
+
+  auto result = pending->Execute();
+  if (result->HasError()) {
+    statement_result.error = result->GetError();
+    return;
+  }
+
+  if (result->properties.return_type == StatementReturnType::CHANGED_ROWS) {
+    statement_result.changed_rows = true;
+    auto chunk = result->Fetch();
+    if (chunk && chunk->size() > 0) {
+      statement_result.row_count = chunk->GetValue(0, 0).GetValue<int64_t>();
+    }
+  } else {
+    // The result is streamed, so dropping each chunk right away means the rows
+    // are never all in memory at once.
+    while (auto chunk = result->FetchRaw()) {
+      statement_result.row_count += chunk->size();
+      if (is_client_gone()) {
+        connection.Interrupt();
+      }
+    }
+  }
+  if (result->HasError()) {
+    statement_result.error = result->GetError();
+  }
+}
+
+std::function<void()>
+HttpServer::MakeQueryProgressReporter(const std::string &connection_name,
+                                      Connection &connection) {
+  auto interval =
+      std::chrono::milliseconds(GetQueryProgressInterval(*connection.context));
+  // Events are tagged with the connection name, so the progress of queries on
+  // unnamed connections can't be told apart.
+  if (interval.count() == 0 || connection_name.empty()) {
+    return [] {};
+  }
+  auto context = connection.context;
+  auto next_report = std::chrono::steady_clock::now() + interval;
+  uint64_t last_rows_processed = 0;
+  return [this, connection_name, context, interval, next_report,
+          last_rows_processed]() mutable {
+    auto now = std::chrono::steady_clock::now();
+    if (now < next_report) {
+      return;
+    }
+    next_report = now + interval;
+    auto progress = context->GetQueryProgress();
+    auto rows_processed = progress.GetRowsProcesseed();
+    // Don't repeat an event when nothing has changed, e.g. while a blocking
+    // operator is finishing.
+    if (rows_processed == last_rows_processed) {
+      return;
+    }
+    last_rows_processed = rows_processed;
+    event_dispatcher->SendQueryProgressEvent(
+        connection_name, rows_processed, progress.GetTotalRowsToProcess(),
+        progress.GetPercentage());
+  };
+}
+
+PendingExecutionResult
+HttpServer::ExecuteTasks(Connection &connection, PendingQueryResult &pending,
+                         const std::function<bool()> &is_client_gone,
+                         const std::function<void()> &report_progress) {
+  // When the remaining tasks of a query are running on other threads, there is
+  // nothing for this thread to do and nothing the executor signals on
+  // (WaitForTask only waits for blocked tasks). This is still a poll: wait in
+  // short, growing intervals, so quick queries don't pay for a long wait and
+  // long ones don't keep this thread busy. The wait is specific to this run,
+  // and cut short if its connection is interrupted.
+  constexpr auto MIN_IDLE_WAIT = std::chrono::microseconds(10);
+  constexpr auto MAX_IDLE_WAIT = std::chrono::microseconds(1000);
+
+  TaskWaiter waiter;
+  struct TaskWaiterRegistration {
+    std::mutex &mutex;
+    std::unordered_multimap<Connection *, TaskWaiter *> &waiters;
+    Connection *connection;
+    TaskWaiter *waiter;
+    ~TaskWaiterRegistration() {
+      std::lock_guard<std::mutex> guard(mutex);
+      auto range = waiters.equal_range(connection);
+      for (auto it = range.first; it != range.second; ++it) {
+        if (it->second == waiter) {
+          waiters.erase(it);
+          break;
+        }
+      }
+    }
+  } registration{task_waiters_mutex, task_waiters, &connection, &waiter};
+  {
+    std::lock_guard<std::mutex> guard(task_waiters_mutex);
+    task_waiters.emplace(&connection, &waiter);
+  }
+
+  // Returns whether the connection was interrupted since the last call. The
+  // interruption itself is reported by the next task of the query, so later
+  // waits must not be cut short by it.
+  auto take_interruption = [&waiter]() {
+    std::lock_guard<std::mutex> guard(waiter.mutex);
+    auto interrupted = waiter.interrupted;
+    waiter.interrupted = false;
+    return interrupted;
+  };
+
+  auto idle_wait = MIN_IDLE_WAIT;
+  auto exec_result = PendingExecutionResult::RESULT_NOT_READY;
+  while (!PendingQueryResult::IsResultReady(exec_result)) {
+    if (is_client_gone()) {
+      // The next task reports the interruption as an execution error.
+      connection.Interrupt();
+    }
+    report_progress();
+    exec_result = pending.ExecuteTask();
+    switch (exec_result) {
+    case PendingExecutionResult::BLOCKED:
+      // Wait until the executor signals that a blocked task was rescheduled.
+      // Nothing outside the executor can signal it, so the wait is skipped
+      // once the connection is interrupted; DuckDB bounds it otherwise.
+      if (!take_interruption()) {
+        pending.WaitForTask();
+      }
+      break;
+    case PendingExecutionResult::NO_TASKS_AVAILABLE: {
+      {
+        std::unique_lock<std::mutex> lock(waiter.mutex);
+        waiter.cv.wait_for(lock, idle_wait,
+                           [&waiter] { return waiter.interrupted; });
+      }
+      idle_wait = take_interruption()
+                      ? MIN_IDLE_WAIT
+                      : std::min(idle_wait * 2, MAX_IDLE_WAIT);
+      break;
+    }
+    default:
+      idle_wait = MIN_IDLE_WAIT;
+      break;
+    }
+  }
+  return exec_result;
+}
+
 void HttpServer::HandleTokenize(const httplib::Request &req,
                                 httplib::Response &res,
                                 const httplib::ContentReader &content_reader) {
@@ -666,9 +2121,112 @@ void HttpServer::HandleTokenize(const httplib::Request &req,
     result.types.push_back(token.type);
   }
 
-  MemoryStream response_content;
-  BinarySerializer::Serialize(result, response_content);
-  SetResponseContent(res, response_content);
+  SetResponseResult(res, result);
+}
+
+void HttpServer::ReleaseResult(const std::string &connection_name,
+                               shared_ptr<ResultReader> reader) {
+  if (!reader->HasResultTable()) {
+    reader->Close();
+    return;
+  }
+
+  auto materializer = make_uniq<ResultMaterializer>(
+      connection_name, std::move(reader),
+      [this, connection_name](const ResultMaterializer::Summary &summary) {
+        event_dispatcher->SendResultTableMaterializedEvent(
+            connection_name, summary.table_name.catalog,
+            summary.table_name.schema, summary.table_name.name,
+            summary.row_count, summary.elapsed.count(), summary.error);
+      });
+
+  // Drop the materializers that are done, while adding the new one.
+  vector<unique_ptr<ResultMaterializer>> done;
+  {
+    std::lock_guard<std::mutex> guard(materializers_mutex);
+    for (auto it = materializers.begin(); it != materializers.end();) {
+      if ((*it)->IsDone()) {
+        done.push_back(std::move(*it));
+        it = materializers.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    materializers.push_back(std::move(materializer));
+  }
+}
+
+void HttpServer::TrackResultTable(const std::string &key,
+                                  shared_ptr<ResultReader> reader) {
+  std::lock_guard<std::mutex> guard(filling_result_tables_mutex);
+  for (auto it = filling_result_tables.begin();
+       it != filling_result_tables.end();) {
+    auto filling_reader = it->second.lock();
+    if (!filling_reader || !filling_reader->IsFillingResultTable()) {
+      it = filling_result_tables.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  filling_result_tables[key] = reader;
+}
+
+bool HttpServer::IsFillingResultTable(const std::string &key) {
+  std::lock_guard<std::mutex> guard(filling_result_tables_mutex);
+  auto it = filling_result_tables.find(key);
+  if (it == filling_result_tables.end()) {
+    return false;
+  }
+  auto reader = it->second.lock();
+  return reader && reader->IsFillingResultTable();
+}
+
+void HttpServer::StopMaterializers(const std::string &connection_name) {
+  // Unnamed connections are not reused, so nothing can be copying from them.
+  if (connection_name.empty()) {
+    return;
+  }
+
+  // Materializers wait for their thread when destroyed, outside of the lock.
+  vector<unique_ptr<ResultMaterializer>> to_stop;
+  {
+    std::lock_guard<std::mutex> guard(materializers_mutex);
+    for (auto it = materializers.begin(); it != materializers.end();) {
+      if ((*it)->GetConnectionName() == connection_name) {
+        to_stop.push_back(std::move(*it));
+        it = materializers.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+  // The new query only needs its own rows, so rather than waiting for the
+  // rest of the previous result to be copied (holding a run slot meanwhile),
+  // the copy is cut short.
+  for (auto &materializer : to_stop) {
+    if (!materializer->IsDone()) {
+      materializer->Interrupt();
+    }
+  }
+}
+
+void HttpServer::StopMaterializers() {
+  vector<unique_ptr<ResultMaterializer>> to_stop;
+  {
+    std::lock_guard<std::mutex> guard(materializers_mutex);
+    to_stop = std::move(materializers);
+    materializers.clear();
+  }
+  for (auto &materializer : to_stop) {
+    materializer->Interrupt();
+  }
+}
+
+unique_ptr<RunRequest> HttpServer::ReadRunRequest(const std::string &content) {
+  MemoryStream stream(
+      reinterpret_cast<data_ptr_t>(const_cast<char *>(content.data())),
+      content.size());
+  return BinaryDeserializer::Deserialize<RunRequest>(stream);
 }
 
 std::string
@@ -681,34 +2239,234 @@ HttpServer::ReadContent(const httplib::ContentReader &content_reader) {
   return oss.str();
 }
 
-void HttpServer::SetResponseContent(httplib::Response &res,
-                                    const MemoryStream &content) {
-  auto data = content.GetData();
-  auto length = content.GetPosition();
-  res.set_content(reinterpret_cast<const char *>(data), length,
-                  "application/octet-stream");
+// Writes part of a streamed response, compressing it if needed.
+static bool WriteToSink(httplib::DataSink &sink,
+                        ResponseCompressor *compressor, const char *data,
+                        idx_t size, bool last) {
+  if (!compressor) {
+    return sink.write(data, size);
+  }
+  std::string compressed;
+  compressor->Compress(data, size, last, compressed);
+  // Writing nothing would end the response.
+  return compressed.empty() || sink.write(compressed.data(), compressed.size());
+}
+
+// Writes a response to the sink in pieces of at least SINK_BUFFER_SIZE bytes,
+// compressing them if needed. Throws if the client can't be written to.
+class SinkWriteStream : public WriteStream {
+public:
+  SinkWriteStream(httplib::DataSink &_sink, ResponseCompressor *_compressor)
+      : sink(_sink), compressor(_compressor) {}
+
+  void WriteData(const_data_ptr_t data, idx_t size) override {
+    buffer.append(reinterpret_cast<const char *>(data), size);
+    if (buffer.size() >= SINK_BUFFER_SIZE) {
+      Flush(false);
+    }
+  }
+
+  void Flush(bool last) {
+    if (buffer.empty() && !(last && compressor)) {
+      return;
+    }
+    if (!WriteToSink(sink, compressor, buffer.data(), buffer.size(), last)) {
+      throw IOException("Failed to write the response");
+    }
+    buffer.clear();
+  }
+
+private:
+  httplib::DataSink &sink;
+  ResponseCompressor *compressor;
+  std::string buffer;
+};
+
+// Sends a result too large to hold in memory. It is serialized as it is
+// written, so only one of its chunks is read back at a time. Its size isn't
+// known up front, so it is compressed whenever the client accepts it.
+static void
+SetResponseSpilledResult(const httplib::Request &req, httplib::Response &res,
+                         shared_ptr<SpilledResult> spilled_result) {
+  shared_ptr<ResponseCompressor> compressor;
+  auto encoding =
+      NegotiateContentEncoding(req.get_header_value("Accept-Encoding"));
+  if (encoding != ContentEncoding::NONE) {
+    compressor =
+        shared_ptr<ResponseCompressor>(ResponseCompressor::Create(encoding));
+    res.set_header("Content-Encoding", ContentEncodingName(encoding));
+    res.set_header("Vary", "Accept-Encoding");
+  }
+
+  // The whole result is written by the first call of the provider. Exceptions
+  // must not escape it, because it is called by httplib after the request
+  // handler has returned.
+  res.set_chunked_content_provider(
+      "application/octet-stream",
+      [spilled_result, compressor](size_t, httplib::DataSink &sink) {
+        try {
+          SinkWriteStream stream(sink, compressor.get());
+          BinarySerializer::Serialize(*spilled_result, stream);
+          stream.Flush(true);
+          sink.done();
+          return true;
+        } catch (std::exception &) {
+          // The response is incomplete, and it's too late to report an error.
+          // Abort it instead.
+          return false;
+        }
+      });
+}
+
+void HttpServer::SetResponseStreamedResult(
+    const httplib::Request &req, httplib::Response &res,
+    const std::string &connection_name, shared_ptr<ResultReader> reader,
+    shared_ptr<ArrowIPCWriter> arrow_writer,
+    shared_ptr<RunScheduler::Ticket> ticket, std::string header_bytes) {
+  if (header_bytes.empty()) {
+    if (arrow_writer) {
+      arrow_writer->WriteSchema(header_bytes);
+    } else {
+      StreamHeader header;
+      header.column_names_and_types = reader->GetColumnNamesAndTypes();
+      StringWriteStream header_stream(header_bytes);
+      BinarySerializer::Serialize(header, header_stream);
+    }
+  }
+
+  // The size of a streamed response isn't known up front, so it is compressed
+  // whenever the client accepts it.
+  shared_ptr<ResponseCompressor> compressor;
+  auto encoding =
+      NegotiateContentEncoding(req.get_header_value("Accept-Encoding"));
+  if (encoding != ContentEncoding::NONE) {
+    compressor =
+        shared_ptr<ResponseCompressor>(ResponseCompressor::Create(encoding));
+    res.set_header("Content-Encoding", ContentEncodingName(encoding));
+    res.set_header("Vary", "Accept-Encoding");
+  }
+
+  // Each call of the provider writes one frame (or Arrow record batch), so only
+  // a single chunk is held in memory at a time. Exceptions must not escape the
+  // provider, because it is called by httplib after the request handler has
+  // returned.
+  // Set once the provider has handed the reader to ReleaseResult or closed it.
+  auto released = make_shared_ptr<bool>(false);
+  res.set_chunked_content_provider(
+      arrow_writer ? ARROW_STREAM_CONTENT_TYPE : "application/octet-stream",
+      [this, connection_name, reader, arrow_writer, header_bytes, compressor,
+       released](size_t offset, httplib::DataSink &sink) {
+        try {
+          if (offset == 0) {
+            return WriteToSink(sink, compressor.get(), header_bytes.data(),
+                               header_bytes.size(), false);
+          }
+
+          StreamFrame frame;
+          try {
+            if (reader->ReadChunk(frame.chunk)) {
+              std::string frame_bytes;
+              if (arrow_writer) {
+                arrow_writer->WriteRecordBatch(frame.chunk, frame_bytes);
+              } else {
+                StringWriteStream frame_stream(frame_bytes);
+                BinarySerializer::Serialize(frame, frame_stream);
+              }
+              return WriteToSink(sink, compressor.get(), frame_bytes.data(),
+                                 frame_bytes.size(), false);
+            }
+            *released = true;
+            ReleaseResult(connection_name, reader);
+          } catch (std::exception &ex) {
+            if (arrow_writer) {
+              // Arrow streams can't carry errors. End the response without
+              // the end-of-stream marker, so the client sees it is incomplete.
+              // The client is still there, so this isn't counted as an abort.
+              *released = true;
+              reader->Close();
+              return false;
+            }
+            ErrorData error(ex);
+            frame.error = error.RawMessage();
+          }
+
+          std::string end_bytes;
+          if (arrow_writer) {
+            ArrowIPCWriter::WriteEndOfStream(end_bytes);
+          } else {
+            frame.done = true;
+            StringWriteStream end_stream(end_bytes);
+            BinarySerializer::Serialize(frame, end_stream);
+          }
+          WriteToSink(sink, compressor.get(), end_bytes.data(),
+                      end_bytes.size(), true);
+          sink.done();
+          return true;
+        } catch (std::exception &) {
+          // Failed to write the end frame, so the error can't be reported to
+          // the client. Abort the response instead.
+          return false;
+        }
+      },
+      // The ticket keeps the run slot until the response is done.
+      [this, reader, released, ticket](bool success) {
+        if (*released) {
+          return;
+        }
+        // The client went away before the end. Nobody will read the rest of
+        // the result or the result table, so drop both.
+        try {
+          if (success) {
+            reader->Close();
+          } else {
+            reader->Abort();
+            run_scheduler->RecordAborted();
+          }
+        } catch (std::exception &) {
+        }
+      });
+}
+
+void HttpServer::CompressResponseBody(const httplib::Request &req,
+                                      httplib::Response &res) {
+  // Smaller responses aren't worth the time to compress them. This also skips
+  // streamed responses, which have no body and are compressed as written.
+  if (res.body.size() < MIN_COMPRESSED_RESPONSE_SIZE) {
+    return;
+  }
+
+  auto encoding =
+      NegotiateContentEncoding(req.get_header_value("Accept-Encoding"));
+  if (encoding == ContentEncoding::NONE) {
+    return;
+  }
+
+  std::string compressed;
+  try {
+    ResponseCompressor::Create(encoding)->Compress(
+        res.body.data(), res.body.size(), true, compressed);
+  } catch (std::exception &) {
+    return; // Fall back to sending the response uncompressed.
+  }
+  if (compressed.size() >= res.body.size()) {
+    return;
+  }
+
+  res.body = std::move(compressed);
+  res.set_header("Content-Encoding", ContentEncodingName(encoding));
+  res.set_header("Vary", "Accept-Encoding");
 }
 
 void HttpServer::SetResponseEmptyResult(httplib::Response &res) {
   EmptyResult empty_result;
-  MemoryStream response_content;
-  BinarySerializer::Serialize(empty_result, response_content);
-  SetResponseContent(res, response_content);
+  SetResponseResult(res, empty_result);
 }
 
 void HttpServer::SetResponseErrorResult(httplib::Response &res,
                                         const std::string &error) {
   ErrorResult error_result;
   error_result.error = error;
-  MemoryStream response_content;
-  BinarySerializer::Serialize(error_result, response_content);
-  SetResponseContent(res, response_content);
-}
-
-void HttpServer::CopyAndSlice(duckdb::DataChunk &source, duckdb::DataChunk &target, idx_t row_count) {
-  target.InitializeEmpty(source.GetTypes());
-  target.Reference(source);
-  target.Slice(0, row_count);
+  SetResponseResult(res, error_result);
 }
 
 } // namespace ui
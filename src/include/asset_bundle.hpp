@@ -0,0 +1,51 @@
+#pragma once
+
+#include <duckdb.hpp>
+
+#include <string>
+#include <unordered_map>
+
+namespace duckdb {
+namespace ui {
+
+// The files of the UI, served without the remote URL, e.g. on hosts without
+// internet access.
+//
+// A bundle is an uncompressed tar archive of the files (e.g. built with
+// `tar -cf bundle.tar -C dist .`). An optional VERSION file holds its version.
+// The archive is memory-mapped and indexed when opened, so assets are served
+// as slices of the mapping, without copying or decompressing them.
+class AssetBundle {
+public:
+  struct Asset {
+    const char *data;
+    idx_t size;
+    std::string content_type;
+  };
+
+  // Maps and indexes the archive at `path`. Throws an IOException if it can't
+  // be read or isn't a tar archive.
+  explicit AssetBundle(const std::string &path);
+  ~AssetBundle();
+
+  // Contents of the VERSION file, or empty if there is none.
+  const std::string &GetVersion() const;
+  idx_t GetAssetCount() const;
+  idx_t GetSizeBytes() const;
+
+  // Looks up the asset for the path of a request. Paths of directories map to
+  // their index.html.
+  bool Find(const std::string &path, Asset &asset) const;
+
+private:
+  void Index();
+
+  const char *data = nullptr;
+  idx_t size_bytes = 0;
+  // Offset and size of each file, by path within the archive.
+  std::unordered_map<std::string, std::pair<idx_t, idx_t>> files;
+  std::string version;
+};
+
+} // namespace ui
+} // namespace duckdb
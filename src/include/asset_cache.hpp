@@ -0,0 +1,83 @@
+#pragma once
+
+#include <duckdb.hpp>
+
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace duckdb {
+namespace ui {
+
+// A response proxied from the remote URL, as stored by the AssetCache.
+struct CachedAsset {
+  // Identifies the request, see AssetCache::MakeKey.
+  std::string key;
+  int32_t status = 0;
+  vector<std::string> header_names;
+  vector<std::string> header_values;
+  std::string body;
+
+  // Returns the value of the first header named `name` (ignoring case), or an
+  // empty string.
+  std::string GetHeader(const std::string &name) const;
+
+  void Serialize(Serializer &serializer) const;
+  static unique_ptr<CachedAsset> Deserialize(Deserializer &deserializer);
+};
+
+// Bounded on-disk cache of the responses proxied from the remote URL, so the
+// UI doesn't have to download its assets again on every launch.
+//
+// Each entry is a file named after the SHA-256 of its key. The least recently
+// used entries are deleted once the files exceed the capacity. Files are read,
+// written and deleted outside of the mutex, which only guards the index.
+// Errors reading or writing the files are ignored: the cache then behaves as
+// if it didn't have the entry.
+class AssetCache {
+public:
+  AssetCache(std::string directory, idx_t capacity_bytes);
+
+  static std::string MakeKey(const std::string &remote_url,
+                             const std::string &path,
+                             const std::string &query);
+
+  // Returns the entry for `key`, or nullptr.
+  unique_ptr<CachedAsset> Get(const std::string &key);
+  void Put(const CachedAsset &asset);
+
+private:
+  struct Entry {
+    std::string file_name;
+    idx_t size_bytes;
+  };
+
+  // Indexes the entries left by previous runs, most recently written first.
+  void Load();
+  std::string GetPath(const std::string &file_name) const;
+  // Drops the least recently used entries until the cache fits, and adds their
+  // files to `file_names_to_remove`.
+  void Evict(vector<std::string> &file_names_to_remove);
+  // Drops the entry from the index. Files are removed by the callers once they
+  // have released the mutex.
+  void Erase(std::list<Entry>::iterator it);
+  void RemoveFiles(const vector<std::string> &file_names);
+
+  unique_ptr<FileSystem> fs;
+  std::string directory;
+  idx_t capacity_bytes;
+
+  std::mutex mutex;
+  // Most recently used first.
+  std::list<Entry> entries;
+  std::unordered_map<std::string, std::list<Entry>::iterator>
+      entries_by_file_name;
+  idx_t size_bytes = 0;
+  // Numbers temp files, so concurrent writes of an entry don't share one.
+  std::atomic<idx_t> next_temp_file_id{0};
+};
+
+} // namespace ui
+} // namespace duckdb
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <duckdb.hpp>
+
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "asset_cache.hpp"
+#include "utils/compression.hpp"
+
+namespace duckdb {
+namespace ui {
+
+// An asset held by the AssetMemoryCache, with its compressed variants.
+struct MemoryCachedAsset {
+  CachedAsset asset;
+  // Empty if the asset isn't compressible, or compressing it didn't make it
+  // smaller.
+  std::string gzip_body;
+  std::string zstd_body;
+
+  // Returns the body to send to a client preferring `encoding`. Falls back to
+  // the uncompressed body, in which case `encoding` is set to NONE.
+  const std::string &GetBody(ContentEncoding &encoding) const;
+  idx_t GetSizeBytes() const;
+};
+
+// Bounded in-memory LRU cache of the immutable assets proxied from the remote
+// URL (the content-hashed files of the UI), so they are served without a round
+// trip to the remote URL.
+//
+// The compressed variants of an asset are computed once, when it is added.
+class AssetMemoryCache {
+public:
+  struct Stats {
+    idx_t hits;
+    idx_t misses;
+    idx_t entry_count;
+    idx_t size_bytes;
+    // Bytes of the bodies sent from the cache.
+    idx_t bytes_served;
+    // Bytes not sent thanks to the compressed variants.
+    idx_t bytes_saved;
+  };
+
+  explicit AssetMemoryCache(idx_t capacity_bytes);
+
+  // Returns the entry for `key`, or nullptr. `encoding` is the one preferred
+  // by the client, and is used to account for the variant sent.
+  shared_ptr<const MemoryCachedAsset> Get(const std::string &key,
+                                          ContentEncoding encoding);
+  void Put(CachedAsset asset);
+
+  Stats GetStats();
+
+private:
+  using Entry = shared_ptr<const MemoryCachedAsset>;
+
+  void Erase(std::list<Entry>::iterator it);
+
+  idx_t capacity_bytes;
+
+  std::mutex mutex;
+  // Most recently used first.
+  std::list<Entry> entries;
+  std::unordered_map<std::string, std::list<Entry>::iterator> entries_by_key;
+  idx_t size_bytes = 0;
+  std::atomic<idx_t> hits{0};
+  std::atomic<idx_t> misses{0};
+  std::atomic<idx_t> bytes_served{0};
+  std::atomic<idx_t> bytes_saved{0};
+};
+
+} // namespace ui
+} // namespace duckdb
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <duckdb.hpp>
+#include <duckdb/common/types/hyperloglog.hpp>
+
+#include "utils/serialization.hpp"
+
+namespace duckdb {
+namespace ui {
+
+// Computes the profiles of the columns of a result from its chunks.
+//
+// Null counts, min/max and distinct estimates are updated chunk by chunk, as
+// the result is read. The histograms need the range of the values, so their
+// bins are filled from the chunks once all of them have been read.
+class ColumnProfiler {
+public:
+  explicit ColumnProfiler(const vector<LogicalType> &types);
+
+  void Update(Chunk &chunk);
+
+  // Returns the profiles, given all the chunks passed to Update.
+  vector<ColumnProfile> Finish(vector<Chunk> &chunks);
+
+  // Same as Finish, for results whose chunks aren't all in memory: once every
+  // chunk has been passed to Update, each is passed again to AddToHistograms
+  // before calling Finish.
+  void AddToHistograms(Chunk &chunk);
+  vector<ColumnProfile> Finish();
+
+  struct ColumnState {
+    LogicalType type;
+    // Whether the column has min/max, and whether it has a histogram.
+    bool ordered = false;
+    bool numeric = false;
+    // Divisor converting the values to doubles, for decimals.
+    double scale = 1;
+
+    idx_t null_count = 0;
+    Value min;
+    Value max;
+    HyperLogLog distinct;
+    // Range of the finite values, as doubles.
+    bool has_range = false;
+    double range_min = 0;
+    double range_max = 0;
+    vector<idx_t> histogram_counts;
+  };
+
+private:
+  vector<ColumnState> columns;
+};
+
+} // namespace ui
+} // namespace duckdb
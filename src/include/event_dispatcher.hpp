@@ -17,6 +17,21 @@ class EventDispatcher {
 public:
   void SendConnectedEvent(const std::string &token);
   void SendCatalogChangedEvent();
+  // Reports that a result table has been filled in the background. The error
+  // is empty if it was completed.
+  void SendResultTableMaterializedEvent(const std::string &connection_name,
+                                        const std::string &database_name,
+                                        const std::string &schema_name,
+                                        const std::string &table_name,
+                                        uint64_t row_count,
+                                        int64_t elapsed_ms,
+                                        const std::string &error);
+  // Reports the progress of the query running on a connection. The percentage
+  // is negative if it isn't known.
+  void SendQueryProgressEvent(const std::string &connection_name,
+                              uint64_t rows_processed,
+                              uint64_t total_rows_to_process,
+                              double percentage);
 
   bool WaitEvent(duckdb_httplib_openssl::DataSink *sink);
   void Close();
@@ -6,20 +6,37 @@
 #define CPPHTTPLIB_OPENSSL_SUPPORT
 #include "httplib.hpp"
 
+#include <atomic>
+#include <condition_variable>
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <thread>
+#include <unordered_map>
 
+#include "asset_bundle.hpp"
+#include "asset_cache.hpp"
+#include "asset_memory_cache.hpp"
 #include "event_dispatcher.hpp"
+#include "remote_client_pool.hpp"
+#include "result_cache.hpp"
+#include "result_materializer.hpp"
+#include "run_scheduler.hpp"
+#include "socket_tracking_server.hpp"
 #include "watcher.hpp"
 
 namespace httplib = duckdb_httplib_openssl;
 
 namespace duckdb {
 class HTTPParams;
-class MemoryStream;
 
 namespace ui {
+class ArrowIPCWriter;
+class ResultReader;
+struct RunRequest;
+struct ScriptResult;
+struct ScriptStatementResult;
 
 class HttpServer {
 
@@ -37,15 +54,38 @@ public:
   static bool Stop();
 
   std::string LocalUrl() const;
+  ResultCache::Stats GetResultCacheStats() const;
+  RunScheduler::Stats GetRunSchedulerStats() const;
+  AssetMemoryCache::Stats GetAssetMemoryCacheStats() const;
+
+  // Installs the asset bundle at `source_path` in the extension data
+  // directory, replacing the previous one, or just loads the installed one if
+  // `source_path` is empty. If the server is running, it switches to serving
+  // the UI from the bundle.
+  static shared_ptr<AssetBundle>
+  LoadAssetBundle(ClientContext &, const std::string &source_path);
+  // Removes the installed asset bundles. If the server is running, it goes
+  // back to serving the UI from the remote URL. Returns the number of bundles
+  // removed.
+  static idx_t UnloadAssetBundle(ClientContext &);
 
 private:
   friend class Watcher;
 
   // Lifecycle
   void DoStart(const uint16_t local_port, const std::string &remote_url,
-               unique_ptr<HTTPParams>);
+               unique_ptr<HTTPParams>, idx_t result_cache_size,
+               idx_t max_concurrent_runs, idx_t max_queued_runs,
+               const std::string &asset_cache_directory,
+               idx_t asset_cache_size, idx_t asset_memory_cache_size,
+               const std::string &asset_bundle_path);
   void DoStop();
   void Run();
+  // Runs in the background after the server starts, so the first page load
+  // of the UI doesn't start cold.
+  void WarmUp();
+  // Fetches the UI document and the assets it references into the caches.
+  void PrefetchAssets();
   void UpdateDatabaseInstance(shared_ptr<DatabaseInstance> context_db);
 
   // Http handlers
@@ -54,7 +94,17 @@ private:
                             httplib::Response &res);
   void HandleGetLocalToken(const httplib::Request &req, httplib::Response &res);
   void HandleGet(const httplib::Request &req, httplib::Response &res);
+  // Forwards a GET request to the remote URL. Returns false if it failed, in
+  // which case `res` holds the error. Prefetches give up connecting sooner.
+  bool ProxyRemoteAsset(const httplib::Request &req, httplib::Response &res,
+                        bool prefetch = false);
   void HandleInterrupt(const httplib::Request &req, httplib::Response &res);
+  void DoHandleFetch(const httplib::Request &req, httplib::Response &res);
+  void HandleFetch(const httplib::Request &req, httplib::Response &res);
+  void DoHandleReadResultTable(const httplib::Request &req,
+                               httplib::Response &res);
+  void HandleReadResultTable(const httplib::Request &req,
+                             httplib::Response &res);
   void DoHandleRun(const httplib::Request &req, httplib::Response &res,
                    const httplib::ContentReader &content_reader);
   void HandleRun(const httplib::Request &req, httplib::Response &res,
@@ -62,9 +112,57 @@ private:
   void HandleTokenize(const httplib::Request &req, httplib::Response &res,
                       const httplib::ContentReader &content_reader);
   std::string ReadContent(const httplib::ContentReader &content_reader);
+  unique_ptr<RunRequest> ReadRunRequest(const std::string &content);
+  // Interrupts the query on the connection if `is_client_gone` returns true.
+  // Calls `report_progress` between tasks.
+  PendingExecutionResult
+  ExecuteTasks(Connection &connection, PendingQueryResult &pending,
+               const std::function<bool()> &is_client_gone,
+               const std::function<void()> &report_progress);
+  // Returns a function sending a QueryProgressEvent for the query running on
+  // the connection, throttled to the configured interval.
+  std::function<void()>
+  MakeQueryProgressReporter(const std::string &connection_name,
+                            Connection &connection);
+  void RunScript(Connection &connection,
+                 vector<unique_ptr<SQLStatement>> &statements,
+                 ScriptResult &script_result,
+                 const std::function<bool()> &is_client_gone,
+                 const std::function<void()> &report_progress);
+  void RunScriptStatement(Connection &connection,
+                          unique_ptr<SQLStatement> statement,
+                          ScriptStatementResult &statement_result,
+                          const std::function<bool()> &is_client_gone,
+                          const std::function<void()> &report_progress);
+
+  // Releases a result once the rows of the response have been read. If it has
+  // a result table, the table is completed in the background.
+  void ReleaseResult(const std::string &connection_name,
+                     shared_ptr<ResultReader> reader);
+  // Tracks the result table being filled by `reader`, by its qualified name.
+  void TrackResultTable(const std::string &key,
+                        shared_ptr<ResultReader> reader);
+  // True if rows may still be added to the result table.
+  bool IsFillingResultTable(const std::string &key);
+  // Stops completing the result tables of the connection, so it can run
+  // another query. The tables keep the rows appended so far, and their
+  // ResultTableMaterializedEvent reports the interruption.
+  void StopMaterializers(const std::string &connection_name);
+  void StopMaterializers();
 
   // Http responses
-  void SetResponseContent(httplib::Response &res, const MemoryStream &content);
+  // Sends the rows of the reader as they are read. If given, `header_bytes`
+  // are sent first instead of the header, e.g. the part of a response that was
+  // buffered before switching to streaming.
+  void SetResponseStreamedResult(const httplib::Request &req,
+                                 httplib::Response &res,
+                                 const std::string &connection_name,
+                                 shared_ptr<ResultReader> reader,
+                                 shared_ptr<ArrowIPCWriter> arrow_writer,
+                                 shared_ptr<RunScheduler::Ticket> ticket,
+                                 std::string header_bytes = std::string());
+  void CompressResponseBody(const httplib::Request &req,
+                            httplib::Response &res);
   void SetResponseEmptyResult(httplib::Response &res);
   void SetResponseErrorResult(httplib::Response &res, const std::string &error);
 
@@ -72,18 +170,50 @@ private:
   shared_ptr<DatabaseInstance> LockDatabaseInstance();
   void InitClientFromParams(httplib::Client &);
 
-  static void CopyAndSlice(duckdb::DataChunk &source, duckdb::DataChunk &target, idx_t row_count);
-
   uint16_t local_port;
   std::string local_url;
   std::string remote_url;
   weak_ptr<DatabaseInstance> ddb_instance;
   std::string user_agent;
-  httplib::Server server;
+  SocketTrackingServer server;
   unique_ptr<std::thread> main_thread;
+  unique_ptr<std::thread> warm_up_thread;
+  std::atomic<bool> warm_up_stopped{false};
   unique_ptr<EventDispatcher> event_dispatcher;
   unique_ptr<Watcher> watcher;
   unique_ptr<HTTPParams> http_params;
+  unique_ptr<ResultCache> result_cache;
+  unique_ptr<RunScheduler> run_scheduler;
+  unique_ptr<RemoteClientPool> remote_client_pool;
+  // Not set if disabled (ui_asset_cache_size = 0).
+  unique_ptr<AssetCache> asset_cache;
+  // Not set if disabled (ui_asset_memory_cache_size = 0).
+  unique_ptr<AssetMemoryCache> asset_memory_cache;
+  // If set, the UI is served from the bundle instead of the remote URL.
+  std::mutex asset_bundle_mutex;
+  shared_ptr<AssetBundle> asset_bundle;
+  // Server threads: those needed for the queries allowed to run or wait at
+  // once, and more for other requests.
+  idx_t server_thread_count = 0;
+
+  // Result tables being completed in the background.
+  std::mutex materializers_mutex;
+  std::vector<unique_ptr<ResultMaterializer>> materializers;
+  // Readers of the result tables that may still be filling, by qualified
+  // table name. Entries are dropped once their table is closed.
+  std::mutex filling_result_tables_mutex;
+  std::unordered_map<std::string, weak_ptr<ResultReader>> filling_result_tables;
+
+  // A request waiting for tasks of its query to become available. Each waits
+  // on its own condition variable, so only the runs of an interrupted
+  // connection are woken.
+  struct TaskWaiter {
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool interrupted = false;
+  };
+  std::mutex task_waiters_mutex;
+  std::unordered_multimap<Connection *, TaskWaiter *> task_waiters;
 
   static unique_ptr<HttpServer> server_instance;
 };
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <duckdb.hpp>
+
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "watcher.hpp"
+
+namespace duckdb {
+namespace ui {
+
+// LRU cache of the prepared statements of a named connection.
+//
+// Entries are keyed by the SQL text and the search path they were bound
+// with. Each entry remembers the catalog state it was prepared under, and is
+// dropped once that changes.
+class PreparedStatementCache {
+public:
+  explicit PreparedStatementCache(idx_t capacity);
+
+  static std::string MakeKey(const std::string &sql,
+                             const std::string &search_path);
+
+  shared_ptr<PreparedStatement> Get(const std::string &key,
+                                    const CatalogState &catalog_state);
+  void Put(const std::string &key, CatalogState catalog_state,
+           shared_ptr<PreparedStatement> prepared);
+
+private:
+  struct Entry {
+    std::string key;
+    CatalogState catalog_state;
+    shared_ptr<PreparedStatement> prepared;
+  };
+
+  std::mutex mutex;
+  // Most recently used first.
+  std::list<Entry> entries;
+  std::unordered_map<std::string, std::list<Entry>::iterator> entries_by_key;
+  idx_t capacity;
+};
+
+} // namespace ui
+} // namespace duckdb
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <duckdb.hpp>
+
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+
+namespace duckdb_httplib_openssl {
+class Client;
+}
+
+struct ssl_st;
+struct ssl_session_st;
+
+namespace duckdb {
+namespace ui {
+
+// Clients of the remote URL the UI assets are fetched from, shared by the
+// server threads.
+//
+// Clients are kept alive between requests, so their connections are reused.
+// When a new connection is needed, it resumes the TLS session of an earlier
+// one, skipping most of the handshake.
+class RemoteClientPool {
+public:
+  // Keeps up to `max_idle_clients` clients between requests. `init_client` is
+  // called on each new client, e.g. to set its timeouts and proxy.
+  RemoteClientPool(
+      std::string remote_url, idx_t max_idle_clients,
+      std::function<void(duckdb_httplib_openssl::Client &)> init_client);
+  ~RemoteClientPool();
+
+  // Takes an idle client, or creates one if there is none. Returns nullptr
+  // once the pool is stopped.
+  unique_ptr<duckdb_httplib_openssl::Client> Acquire();
+  // Returns a client once its request is done.
+  void Release(unique_ptr<duckdb_httplib_openssl::Client> client);
+  // Cancels the requests of the clients in use: their sockets are shut down,
+  // so they fail instead of waiting for the remote URL. Requests still
+  // connecting wait for their connection timeout.
+  void Stop();
+
+private:
+  unique_ptr<duckdb_httplib_openssl::Client> CreateClient();
+  // Called by OpenSSL as the connections of the clients progress, to offer
+  // them the latest session.
+  static void OnInfo(const ssl_st *ssl, int where, int ret);
+  // Called by OpenSSL with each session the server issues.
+  static int OnNewSession(ssl_st *ssl, ssl_session_st *session);
+
+  std::string remote_url;
+  idx_t max_idle_clients;
+  std::function<void(duckdb_httplib_openssl::Client &)> init_client;
+
+  std::mutex mutex;
+  vector<unique_ptr<duckdb_httplib_openssl::Client>> idle_clients;
+  std::unordered_set<duckdb_httplib_openssl::Client *> clients_in_use;
+  bool stopped = false;
+  // Latest session issued by the server, offered by new connections.
+  ssl_session_st *session = nullptr;
+};
+
+} // namespace ui
+} // namespace duckdb
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <duckdb.hpp>
+#include <duckdb/common/random_engine.hpp>
+
+#include "utils/serialization.hpp"
+
+namespace duckdb {
+namespace ui {
+
+// Keeps a uniform random sample of a fixed number of rows from a stream of
+// chunks (reservoir sampling, using Li's "Algorithm L").
+//
+// The sampled rows are kept in one columnar chunk. Once the reservoir is full,
+// the number of rows to skip before the next replacement is drawn up front, so
+// the rows in between are not touched at all.
+class ReservoirSampler {
+public:
+  // A negative seed picks a random one. If the reservoir outgrows
+  // `memory_budget` (in bytes) while it is being filled, the sample is limited
+  // to the rows it holds at that point.
+  ReservoirSampler(const vector<LogicalType> &types, idx_t sample_size,
+                   int64_t seed, idx_t memory_budget);
+
+  void Add(DataChunk &chunk);
+
+  // Returns the sampled rows, split into chunks of at most
+  // STANDARD_VECTOR_SIZE rows.
+  vector<Chunk> GetChunks();
+
+private:
+  // Draws the position of the next row to add to the full reservoir.
+  void SkipRows();
+
+  idx_t sample_size;
+  idx_t memory_budget;
+  // Allocated size of the rows added while filling the reservoir.
+  idx_t reservoir_size_bytes = 0;
+  RandomEngine random;
+  DataChunk reservoir;
+  idx_t rows_seen = 0;
+  // Position of the next row to add, once the reservoir is full.
+  idx_t next_row = 0;
+  double w = 0;
+};
+
+} // namespace ui
+} // namespace duckdb
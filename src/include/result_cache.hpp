@@ -0,0 +1,112 @@
+#pragma once
+
+#include <duckdb.hpp>
+
+#include <atomic>
+#include <list>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "watcher.hpp"
+
+namespace duckdb {
+namespace ui {
+
+// Versions of the attached databases a result was computed from: their catalog
+// versions, and the last transaction committed to each one.
+struct DataState {
+  CatalogState catalog_state;
+  std::map<idx_t, transaction_t> db_to_last_commit;
+
+  bool operator==(const DataState &other) const {
+    return catalog_state == other.catalog_state &&
+           db_to_last_commit == other.db_to_last_commit;
+  }
+};
+
+// Reads the data state of the attached (non-temporary) databases. Returns false
+// if a database doesn't track its commits (e.g. one attached through another
+// extension), in which case results can't be cached. Uses its own transaction,
+// so the connection must not be in one already.
+bool GetDataState(DatabaseInstance &db, Connection &connection,
+                  DataState &state);
+
+// Bounded LRU cache of serialized results of read-only, deterministic queries
+// reading DuckDB tables.
+//
+// Each entry remembers the data state of the attached databases at the time
+// the query ran, and is only used while it is unchanged, whichever connection
+// changed it. Entries are specific to a connection, whose settings and
+// temporary tables affect the result, and to the search path in effect.
+class ResultCache {
+public:
+  struct Stats {
+    idx_t hits;
+    idx_t misses;
+    idx_t entry_count;
+    idx_t size_bytes;
+  };
+
+  explicit ResultCache(idx_t capacity_bytes);
+
+  // `batch_size` is the number of rows chunks are combined into, which changes
+  // the serialized result.
+  static std::string MakeKey(const std::string &connection_name,
+                             const std::string &sql,
+                             const vector<Value> &parameters,
+                             const std::string &search_path,
+                             idx_t result_row_limit, idx_t batch_size,
+                             idx_t serialization_version);
+
+  // Returns whether the result of `sql` can be cached: it may only read DuckDB
+  // tables, and use functions whose result is the same for the same data.
+  // Answering plans the query, so the answer is kept for `key` while the
+  // catalog is unchanged.
+  bool IsCacheable(Connection &connection, const std::string &sql,
+                   const std::string &key, const CatalogState &catalog_state);
+
+  // Looks up the result for `key`. Entries created under a different data
+  // state are dropped.
+  bool Get(const std::string &key, const DataState &data_state,
+           std::string &result_bytes);
+
+  // Incremented by Clear. A result is only stored if the cache wasn't cleared
+  // since the query producing it started, so results computed concurrently
+  // with a write are not kept.
+  idx_t GetGeneration();
+  void Put(const std::string &key, idx_t generation, DataState data_state,
+           std::string result_bytes);
+  void Clear();
+
+  Stats GetStats();
+
+private:
+  struct Entry {
+    std::string key;
+    DataState data_state;
+    std::string result_bytes;
+  };
+
+  struct Verdict {
+    CatalogState catalog_state;
+    bool cacheable;
+  };
+
+  void Erase(std::list<Entry>::iterator it);
+
+  std::mutex mutex;
+  // Most recently used first.
+  std::list<Entry> entries;
+  std::unordered_map<std::string, std::list<Entry>::iterator> entries_by_key;
+  idx_t capacity_bytes;
+  idx_t size_bytes = 0;
+  idx_t generation = 0;
+  std::unordered_map<std::string, Verdict> verdicts_by_key;
+  std::atomic<idx_t> hits{0};
+  std::atomic<idx_t> misses{0};
+};
+
+} // namespace ui
+} // namespace duckdb
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <duckdb.hpp>
+#include <duckdb/parser/qualified_name.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <thread>
+
+namespace duckdb {
+namespace ui {
+
+class ResultReader;
+
+// Appends the rows of a result beyond those in the response to its result
+// table on a background thread, so the response doesn't wait for the copy.
+class ResultMaterializer {
+public:
+  struct Summary {
+    QualifiedName table_name;
+    idx_t row_count = 0;
+    // Time since the result table was created.
+    std::chrono::milliseconds elapsed{0};
+    // Set if the result table could not be completed.
+    std::string error;
+  };
+
+  ResultMaterializer(std::string connection_name,
+                     shared_ptr<ResultReader> reader,
+                     std::function<void(const Summary &)> on_done);
+  // Waits for the materializer to finish.
+  ~ResultMaterializer();
+
+  const std::string &GetConnectionName() const;
+  bool IsDone() const;
+  // Stops filling the result table. It keeps the rows appended so far.
+  void Interrupt();
+  void Wait();
+
+private:
+  void Run();
+
+  std::string connection_name;
+  shared_ptr<ResultReader> reader;
+  std::function<void(const Summary &)> on_done;
+  std::atomic<bool> done{false};
+  std::thread thread;
+};
+
+} // namespace ui
+} // namespace duckdb
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <duckdb.hpp>
+#include <duckdb/parser/qualified_name.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <string>
+
+#include "utils/serialization.hpp"
+
+namespace duckdb {
+namespace ui {
+
+class ReservoirSampler;
+
+// Reads the chunks of a query result for a /ddb/run request. Each chunk is
+// appended to the result table (if any) and limited to the requested number of
+// rows before being handed out. Rows beyond those in the response are appended
+// to the result table by FinishResultTable, which can run after the response
+// has been sent.
+//
+// Owns the connection and the query result, so reading can continue after the
+// request handler has returned (e.g. for streamed responses).
+class ResultReader {
+public:
+  ResultReader(shared_ptr<Connection> connection,
+               unique_ptr<QueryResult> result, idx_t result_row_limit,
+               idx_t result_table_row_limit);
+
+  // Creates the result table and an appender to fill it.
+  void CreateResultTable(DatabaseInstance &db, const std::string &database_name,
+                         const std::string &schema_name,
+                         const std::string &table_name);
+
+  ColumnNamesAndTypes GetColumnNamesAndTypes() const;
+
+  bool HasResultTable() const;
+  // True from the creation of the result table until it is closed, i.e. while
+  // rows may still be added to it. Can be called from any thread.
+  bool IsFillingResultTable() const;
+  const QualifiedName &GetResultTableName() const;
+  // Time the result table was created at.
+  std::chrono::steady_clock::time_point GetResultTableCreationTime() const;
+
+  // True once all rows of the result have been read.
+  bool IsExhausted() const;
+
+  // Sets whether the chunks read are serialized with compressed vectors.
+  void SetCompressVectors(bool compress_vectors);
+
+  // Sets the number of rows to coalesce fetched chunks into, so large results
+  // are sent in fewer chunks. 0 (the default) hands out chunks as fetched.
+  // Batches are cut short once they reach MAX_BATCH_BYTES, or once
+  // MAX_BATCH_DELAY_MS has passed since their first chunk was fetched.
+  void SetBatchSize(idx_t batch_size);
+  // Sets whether the first chunk read is coalesced too. If not, it is handed
+  // out as fetched, so the first rows of a streamed result aren't delayed.
+  void SetBatchFirstChunk(bool batch_first_chunk);
+
+  // Allows reading up to `row_limit` more rows, e.g. for the next page of a
+  // cursor.
+  void ResetRowLimit(idx_t row_limit);
+
+  // Reads the next chunk to include in the response. Returns false once the
+  // result is exhausted or the result row limit is reached.
+  bool ReadChunk(Chunk &chunk);
+
+  // Reads the rest of the result into the sampler, instead of reading its first
+  // rows. The rows are still appended to the result table. Returns false if
+  // `should_stop` returned true before the end of the result.
+  bool ReadSample(ReservoirSampler &sampler,
+                  const std::function<bool()> &should_stop);
+
+  // Appends the rest of the result to the result table, up to its row limit,
+  // then closes the reader. Returns the number of rows in the result table.
+  idx_t FinishResultTable();
+
+  // Interrupts the query on the connection. Can be called from any thread.
+  void Interrupt();
+
+  // Flushes the result table and releases the query result. Safe to call more
+  // than once.
+  void Close();
+
+  // Releases the query result and drops the partially filled result table, if
+  // any. Used when nobody is left to read the result.
+  void Abort();
+
+  static void CopyAndSlice(DataChunk &source, DataChunk &target,
+                           idx_t offset, idx_t row_count);
+  static idx_t GetAllocationSize(DataChunk &chunk);
+
+private:
+  // Fetches the next chunk, and appends it to the result table if needed.
+  unique_ptr<DataChunk> FetchAndAppend();
+  // Fetches chunks until `batch_size` rows or `max_rows` rows, whichever is
+  // smaller, have been read (or the batch is cut short), and combines them
+  // into one chunk.
+  unique_ptr<DataChunk> FetchBatch(idx_t max_rows);
+
+  shared_ptr<Connection> connection;
+  unique_ptr<QueryResult> result;
+  ColumnNamesAndTypes column_names_and_types;
+  // Rows of the last fetched chunk beyond the row limit.
+  unique_ptr<DataChunk> remainder;
+
+  // We use a separate connection for the appender, including creating the
+  // result table, because we still need to fetch chunks from the pending
+  // query on the user's connection.
+  unique_ptr<Connection> appender_connection;
+  unique_ptr<Appender> appender;
+  QualifiedName result_table_name;
+  std::chrono::steady_clock::time_point result_table_created_at;
+  std::atomic<bool> filling_result_table{false};
+
+  idx_t result_row_limit;
+  idx_t result_table_row_limit;
+  idx_t rows_appended = 0;
+  idx_t rows_in_result = 0;
+  bool compress_vectors = false;
+  idx_t batch_size = 0;
+  bool batch_first_chunk = true;
+};
+
+} // namespace ui
+} // namespace duckdb
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <duckdb.hpp>
+
+#include <chrono>
+#include <condition_variable>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace duckdb {
+namespace ui {
+
+// Admission control for /ddb/run requests, and /ddb/fetch requests reading
+// the rest of their results.
+//
+// Limits the number of requests running at once, overall and per named
+// connection (a connection can only run one query at a time). Requests beyond
+// the limits wait in a bounded queue, interactive ones ahead of background
+// ones. When the queue is full, requests are rejected right away, so the client
+// can retry later instead of tying up a server thread.
+class RunScheduler {
+public:
+  enum class Priority : uint8_t { INTERACTIVE = 0, BACKGROUND = 1 };
+
+  struct Stats {
+    idx_t running;
+    idx_t queued;
+    idx_t admitted;
+    idx_t rejected;
+    // Requests whose client disconnected before the response was complete.
+    idx_t aborted;
+    // Time spent in the queue by the admitted requests.
+    std::chrono::microseconds total_wait;
+    std::chrono::microseconds max_wait;
+  };
+
+  // Holds a running slot until destroyed.
+  class Ticket {
+  public:
+    Ticket(RunScheduler &scheduler, std::string connection_name);
+    ~Ticket();
+
+  private:
+    RunScheduler &scheduler;
+    std::string connection_name;
+  };
+
+  RunScheduler(idx_t max_running, idx_t max_queued);
+
+  // Uses the X-DuckDB-UI-Request-Priority header if given, and otherwise
+  // treats requests described as background work as such.
+  static Priority GetPriority(const std::string &priority,
+                              const std::string &description);
+
+  // Waits until the request may run. Returns null if it was rejected, because
+  // the queue was full or the request was cancelled. `error` says which.
+  unique_ptr<Ticket> Admit(const std::string &connection_name,
+                           Priority priority, std::string &error);
+
+  // Rejects the queued requests of the connection.
+  void CancelQueued(const std::string &connection_name);
+
+  // Rejects all queued and future requests, so server threads waiting in Admit
+  // return before the server stops.
+  void Close();
+
+  // Counts a request abandoned by its client.
+  void RecordAborted();
+
+  Stats GetStats();
+
+private:
+  struct Waiter {
+    std::string connection_name;
+    Priority priority;
+    bool admitted = false;
+    std::string error;
+  };
+
+  bool CanRun(const std::string &connection_name);
+  void StartRunning(const std::string &connection_name);
+  void Release(const std::string &connection_name);
+  // Admits the waiters that can run, in the order of the queue.
+  void AdmitWaiters();
+
+  idx_t max_running;
+  idx_t max_queued;
+  bool closed = false;
+
+  std::mutex mutex;
+  std::condition_variable cv;
+  // Ordered by priority, then arrival.
+  std::list<Waiter *> queue;
+  idx_t running = 0;
+  std::unordered_map<std::string, idx_t> running_by_connection;
+
+  idx_t admitted = 0;
+  idx_t rejected = 0;
+  idx_t aborted = 0;
+  std::chrono::microseconds total_wait{0};
+  std::chrono::microseconds max_wait{0};
+};
+
+} // namespace ui
+} // namespace duckdb
@@ -9,6 +9,24 @@
 #define UI_REMOTE_URL_SETTING_DEFAULT "https://ui.duckdb.org"
 #define UI_POLLING_INTERVAL_SETTING_NAME "ui_polling_interval"
 #define UI_POLLING_INTERVAL_SETTING_DEFAULT 284
+#define UI_CURSOR_IDLE_TIMEOUT_SETTING_NAME "ui_cursor_idle_timeout"
+#define UI_CURSOR_IDLE_TIMEOUT_SETTING_DEFAULT 60000
+#define UI_RESULT_CACHE_SIZE_SETTING_NAME "ui_result_cache_size"
+#define UI_RESULT_CACHE_SIZE_SETTING_DEFAULT (64 * 1024 * 1024)
+#define UI_MAX_CONCURRENT_RUNS_SETTING_NAME "ui_max_concurrent_runs"
+#define UI_MAX_CONCURRENT_RUNS_SETTING_DEFAULT 4
+#define UI_MAX_QUEUED_RUNS_SETTING_NAME "ui_max_queued_runs"
+#define UI_MAX_QUEUED_RUNS_SETTING_DEFAULT 16
+#define UI_QUERY_PROGRESS_INTERVAL_SETTING_NAME "ui_query_progress_interval"
+#define UI_QUERY_PROGRESS_INTERVAL_SETTING_DEFAULT 500
+#define UI_RESULT_BATCH_SIZE_SETTING_NAME "ui_result_batch_size"
+#define UI_RESULT_BATCH_SIZE_SETTING_DEFAULT (64 * 1024)
+#define UI_RESULT_MEMORY_BUDGET_SETTING_NAME "ui_result_memory_budget"
+#define UI_RESULT_MEMORY_BUDGET_SETTING_DEFAULT (256 * 1024 * 1024)
+#define UI_ASSET_CACHE_SIZE_SETTING_NAME "ui_asset_cache_size"
+#define UI_ASSET_CACHE_SIZE_SETTING_DEFAULT (128 * 1024 * 1024)
+#define UI_ASSET_MEMORY_CACHE_SIZE_SETTING_NAME "ui_asset_memory_cache_size"
+#define UI_ASSET_MEMORY_CACHE_SIZE_SETTING_DEFAULT (32 * 1024 * 1024)
 
 namespace duckdb {
 
@@ -28,5 +46,14 @@ T GetSetting(const ClientContext &context, const char *setting_name) {
 std::string GetRemoteUrl(const ClientContext &);
 uint16_t GetLocalPort(const ClientContext &);
 uint32_t GetPollingInterval(const ClientContext &);
+uint32_t GetCursorIdleTimeout(const ClientContext &);
+uint64_t GetResultCacheSize(const ClientContext &);
+uint32_t GetMaxConcurrentRuns(const ClientContext &);
+uint32_t GetMaxQueuedRuns(const ClientContext &);
+uint32_t GetQueryProgressInterval(const ClientContext &);
+uint32_t GetResultBatchSize(const ClientContext &);
+uint64_t GetResultMemoryBudget(const ClientContext &);
+uint64_t GetAssetCacheSize(const ClientContext &);
+uint64_t GetAssetMemoryCacheSize(const ClientContext &);
 
 } // namespace duckdb
@@ -0,0 +1,32 @@
+#pragma once
+
+#define CPPHTTPLIB_OPENSSL_SUPPORT
+#include "httplib.hpp"
+
+namespace httplib = duckdb_httplib_openssl;
+
+namespace duckdb {
+namespace ui {
+
+// An httplib server whose handlers can tell whether the client of their
+// request is still connected.
+//
+// httplib doesn't give handlers the socket of their request, but runs them on
+// the thread processing the socket. So the socket is recorded for that thread
+// while it is processed.
+class SocketTrackingServer : public httplib::Server {
+public:
+  // Returns the socket of the request handled by the calling thread, or
+  // INVALID_SOCKET if the thread isn't processing one.
+  static httplib::socket_t GetCurrentSocket();
+
+  // Returns whether the client on `sock` is still connected. An invalid socket
+  // counts as connected, as nothing tells otherwise.
+  static bool IsClientConnected(httplib::socket_t sock);
+
+private:
+  bool process_and_close_socket(httplib::socket_t sock) override;
+};
+
+} // namespace ui
+} // namespace duckdb
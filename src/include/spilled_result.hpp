@@ -0,0 +1,48 @@
+#pragma once
+
+#include <duckdb.hpp>
+#include <duckdb/common/types/column/column_data_collection.hpp>
+
+#include <string>
+
+#include "utils/serialization.hpp"
+
+namespace duckdb {
+namespace ui {
+
+class ColumnProfiler;
+
+// A result read for a buffered response that grew beyond the memory budget
+// (ui_result_memory_budget). Its chunks are kept in a ColumnDataCollection,
+// whose blocks are managed by the buffer manager: under memory pressure they
+// are written to DuckDB's temp directory, instead of exhausting memory.
+//
+// The response is serialized from the collection one chunk at a time, laid out
+// like the SuccessResult it replaces, so clients can't tell the difference.
+class SpilledResult {
+public:
+  // Takes the chunks of `result` read so far. If given, `profiler` must have
+  // been updated with them.
+  SpilledResult(ClientContext &context, SuccessResult &&result,
+                unique_ptr<ColumnProfiler> profiler);
+  ~SpilledResult();
+
+  // Adds the next chunk of the result, and updates the profiler with it.
+  void Append(Chunk &chunk);
+
+  void SetCursorId(const std::string &cursor_id);
+
+  void Serialize(Serializer &serializer) const;
+
+private:
+  void AppendToCollection(Chunk &chunk);
+
+  ColumnNamesAndTypes column_names_and_types;
+  ColumnDataCollection collection;
+  std::string cursor_id;
+  unique_ptr<ColumnProfiler> profiler;
+  bool compress_vectors = false;
+};
+
+} // namespace ui
+} // namespace duckdb
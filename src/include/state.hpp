@@ -1,5 +1,6 @@
 #pragma once
 
+#include <chrono>
 #include <string>
 #include <duckdb/storage/storage_extension.hpp>
 #include <duckdb/main/connection.hpp>
@@ -7,6 +8,11 @@
 namespace duckdb {
 const static std::string STORAGE_EXTENSION_KEY = "ui";
 
+namespace ui {
+class PreparedStatementCache;
+class ResultReader;
+} // namespace ui
+
 class UIStorageExtensionInfo : public StorageExtensionInfo {
 public:
   static UIStorageExtensionInfo &GetState(const DatabaseInstance &instance);
@@ -16,9 +22,41 @@ public:
   FindOrCreateConnection(DatabaseInstance &db,
                          const std::string &connection_name);
 
+  // Result cursors keep the result of a run open, so more rows can be fetched
+  // later. There is at most one cursor per named connection, because running
+  // another query on the connection invalidates the previous result.
+  void PutCursor(const std::string &connection_name,
+                 const std::string &cursor_id,
+                 shared_ptr<ui::ResultReader> reader,
+                 std::chrono::milliseconds idle_timeout);
+  // Removes the cursor from the connection and returns it, if it exists and has
+  // not expired. Put it back to keep it open.
+  shared_ptr<ui::ResultReader> TakeCursor(const std::string &connection_name,
+                                          const std::string &cursor_id);
+  void CloseCursor(const std::string &connection_name);
+  void EvictIdleCursors();
+
+  // Returns the prepared statement cache of a named connection, creating it if
+  // needed. Unnamed connections don't outlive their request, so they have none.
+  shared_ptr<ui::PreparedStatementCache>
+  GetPreparedStatementCache(const std::string &connection_name);
+
 private:
   std::mutex connections_mutex;
   std::unordered_map<std::string, shared_ptr<Connection>> connections;
+
+  struct Cursor {
+    std::string id;
+    shared_ptr<ui::ResultReader> reader;
+    std::chrono::steady_clock::time_point expires_at;
+  };
+
+  std::mutex cursors_mutex;
+  std::unordered_map<std::string, Cursor> cursors;
+
+  std::mutex prepared_statement_caches_mutex;
+  std::unordered_map<std::string, shared_ptr<ui::PreparedStatementCache>>
+      prepared_statement_caches;
 };
 
 } // namespace duckdb
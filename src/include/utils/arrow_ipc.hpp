@@ -0,0 +1,48 @@
+#pragma once
+
+#include <duckdb.hpp>
+#include <duckdb/common/arrow/arrow_type_extension.hpp>
+#include <duckdb/common/arrow/arrow_wrapper.hpp>
+#include <duckdb/main/client_properties.hpp>
+
+#include <string>
+
+#include "utils/serialization.hpp"
+
+namespace duckdb {
+namespace ui {
+
+#define ARROW_STREAM_CONTENT_TYPE "application/vnd.apache.arrow.stream"
+
+// Writes a query result in the Arrow IPC streaming format: a schema message,
+// one record batch message per chunk, and an end-of-stream marker.
+//
+// Chunks are converted using DuckDB's Arrow conversion. Types that would need
+// dictionary or union messages (ENUM and UNION) are sent as VARCHAR.
+class ArrowIPCWriter {
+public:
+  ArrowIPCWriter(shared_ptr<ClientContext> context,
+                 const ColumnNamesAndTypes &column_names_and_types);
+
+  // Appends the schema message to `out`.
+  void WriteSchema(std::string &out);
+
+  // Appends a record batch message holding the rows of `chunk` to `out`.
+  void WriteRecordBatch(Chunk &chunk, std::string &out);
+
+  // Appends the end-of-stream marker to `out`.
+  static void WriteEndOfStream(std::string &out);
+
+private:
+  shared_ptr<ClientContext> context;
+  // Types of the result, and the types they are sent as.
+  vector<LogicalType> types;
+  vector<LogicalType> arrow_types;
+  ClientProperties options;
+  ArrowSchemaWrapper schema;
+  unordered_map<idx_t, const shared_ptr<ArrowTypeExtensionData>>
+      extension_types;
+};
+
+} // namespace ui
+} // namespace duckdb
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <duckdb.hpp>
+
+#include <string>
+
+namespace duckdb {
+namespace ui {
+
+enum class ContentEncoding : uint8_t { NONE, GZIP, ZSTD };
+
+// Picks the encoding of a response from the Accept-Encoding header of the
+// request. Prefers zstd over gzip, and skips codings with a q-value of 0.
+ContentEncoding NegotiateContentEncoding(const std::string &accept_encoding);
+
+const char *ContentEncodingName(ContentEncoding encoding);
+
+// Compresses a response body incrementally. The output of each call is
+// flushed, so everything compressed so far can be decoded by the client before
+// the rest of the body arrives.
+class ResponseCompressor {
+public:
+  static unique_ptr<ResponseCompressor> Create(ContentEncoding encoding);
+
+  virtual ~ResponseCompressor() = default;
+
+  // Appends the compressed data to `out`. Pass `last` with the final piece to
+  // end the compressed stream.
+  virtual void Compress(const char *data, idx_t size, bool last,
+                        std::string &out) = 0;
+};
+
+} // namespace ui
+} // namespace duckdb
@@ -1,12 +1,50 @@
 #pragma once
 
 #include "duckdb.hpp"
+#include "duckdb/common/serializer/write_stream.hpp"
 
 #include <string>
 
 namespace duckdb {
 namespace ui {
 
+// Latest version of the serialization of results. Clients ask for a version
+// using the X-DuckDB-UI-Serialization-Version header, and get version 1 if they
+// don't.
+//
+// Version 2 keeps constant, dictionary and sequence vectors compressed (see
+// Chunk::Serialize).
+//
+// Version 3 allows chunks to hold more than STANDARD_VECTOR_SIZE rows, so
+// results can be sent in fewer, larger batches (see ResultReader).
+#define UI_SERIALIZATION_VERSION 3
+
+// Appends the data written to it to a string, e.g. the body of a response, so
+// it doesn't need to be copied there from another buffer.
+class StringWriteStream : public duckdb::WriteStream {
+public:
+  explicit StringWriteStream(std::string &_target) : target(_target) {}
+
+  void WriteData(duckdb::const_data_ptr_t buffer,
+                 duckdb::idx_t write_size) override {
+    target.append(reinterpret_cast<const char *>(buffer), write_size);
+  }
+
+private:
+  std::string &target;
+};
+
+// Body of a /ddb/run request in binary format: the SQL text and its typed
+// parameters. Unlike parameters passed in headers, these keep their types, and
+// there is no limit on their number or size.
+struct RunRequest {
+  std::string sql;
+  duckdb::vector<duckdb::Value> parameters;
+
+  static duckdb::unique_ptr<RunRequest>
+  Deserialize(duckdb::Deserializer &deserializer);
+};
+
 struct EmptyResult {
   void Serialize(duckdb::Serializer &serializer) const;
 };
@@ -26,8 +64,36 @@ struct ColumnNamesAndTypes {
 };
 
 struct Chunk {
-  uint16_t row_count;
+  // Written as a varint, so widening it didn't change the format. Clients older
+  // than version 3 only expect up to STANDARD_VECTOR_SIZE rows.
+  uint32_t row_count;
   duckdb::vector<duckdb::Vector> vectors;
+  // If set, vectors are serialized using version 2, otherwise they are
+  // flattened.
+  bool compress_vectors = false;
+
+  // Size of the vectors in memory, including their string and child data.
+  duckdb::idx_t GetAllocationSize() const;
+
+  void Serialize(duckdb::Serializer &serializer) const;
+};
+
+// Summary of the values of a column in a result.
+struct ColumnProfile {
+  idx_t null_count = 0;
+  idx_t distinct_count_estimate = 0;
+  // Smallest and largest values, formatted as strings. Only set for numeric,
+  // temporal and string columns with non-null values.
+  bool has_min_max = false;
+  std::string min;
+  std::string max;
+  // Counts of the values in equal-width bins between histogram_min and
+  // histogram_max. Only set for numeric and temporal columns with non-null
+  // values. Temporal values are in their numeric representation (e.g. days
+  // since the epoch for DATE, microseconds for TIMESTAMP).
+  double histogram_min = 0;
+  double histogram_max = 0;
+  duckdb::vector<idx_t> histogram_counts;
 
   void Serialize(duckdb::Serializer &serializer) const;
 };
@@ -35,6 +101,49 @@ struct Chunk {
 struct SuccessResult {
   ColumnNamesAndTypes column_names_and_types;
   duckdb::vector<Chunk> chunks;
+  // Set if more rows can be fetched using /ddb/fetch.
+  std::string cursor_id;
+  // One per column, if requested.
+  duckdb::vector<ColumnProfile> column_profiles;
+
+  void Serialize(duckdb::Serializer &serializer) const;
+};
+
+// First object of a streamed result. Followed by a sequence of StreamFrames.
+struct StreamHeader {
+  ColumnNamesAndTypes column_names_and_types;
+
+  void Serialize(duckdb::Serializer &serializer) const;
+};
+
+// Carries either the next chunk of a streamed result, or marks its end. An
+// error encountered while reading the result is reported in the end frame.
+struct StreamFrame {
+  bool done = false;
+  Chunk chunk;
+  std::string error;
+
+  void Serialize(duckdb::Serializer &serializer) const;
+};
+
+// Outcome of one statement of a script run.
+struct ScriptStatementResult {
+  std::string statement_type;
+  uint64_t elapsed_microseconds = 0;
+  // Number of rows changed by the statement, if it changes rows, or else the
+  // number of rows it returned.
+  bool changed_rows = false;
+  idx_t row_count = 0;
+  std::string error;
+
+  void Serialize(duckdb::Serializer &serializer) const;
+};
+
+// Response of a script run. Lists the statements that ran, up to and including
+// the first one that failed.
+struct ScriptResult {
+  std::string error;
+  duckdb::vector<ScriptStatementResult> statements;
 
   void Serialize(duckdb::Serializer &serializer) const;
 };
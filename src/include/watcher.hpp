@@ -10,7 +10,16 @@ namespace duckdb {
 namespace ui {
 struct CatalogState {
   std::map<idx_t, optional_idx> db_to_catalog_version;
+
+  bool operator==(const CatalogState &other) const {
+    return db_to_catalog_version == other.db_to_catalog_version;
+  }
 };
+
+// Reads the catalog versions of the attached (non-temporary) databases.
+// Uses its own transaction, so the connection must not be in one already.
+CatalogState GetCatalogState(DatabaseInstance &db, Connection &connection);
+
 class HttpServer;
 class Watcher {
 public:
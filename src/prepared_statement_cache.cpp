@@ -0,0 +1,65 @@
+#include "prepared_statement_cache.hpp"
+
+namespace duckdb {
+namespace ui {
+
+PreparedStatementCache::PreparedStatementCache(idx_t _capacity)
+    : capacity(_capacity) {}
+
+// Keyed on the exact SQL text: normalizing it would have to understand
+// comments and every kind of quoting to never map different statements to the
+// same entry. The text is prefixed with its length, so no SQL and search path
+// can produce the key of another pair.
+std::string PreparedStatementCache::MakeKey(const std::string &sql,
+                                            const std::string &search_path) {
+  auto key = std::to_string(sql.size());
+  key += ':';
+  key += sql;
+  key += search_path;
+  return key;
+}
+
+shared_ptr<PreparedStatement>
+PreparedStatementCache::Get(const std::string &key,
+                            const CatalogState &catalog_state) {
+  std::lock_guard<std::mutex> guard(mutex);
+  auto it = entries_by_key.find(key);
+  if (it == entries_by_key.end()) {
+    return nullptr;
+  }
+
+  if (!(it->second->catalog_state == catalog_state)) {
+    entries.erase(it->second);
+    entries_by_key.erase(it);
+    return nullptr;
+  }
+
+  entries.splice(entries.begin(), entries, it->second);
+  return it->second->prepared;
+}
+
+void PreparedStatementCache::Put(const std::string &key,
+                                 CatalogState catalog_state,
+                                 shared_ptr<PreparedStatement> prepared) {
+  if (capacity == 0) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> guard(mutex);
+  auto it = entries_by_key.find(key);
+  if (it != entries_by_key.end()) {
+    entries.erase(it->second);
+    entries_by_key.erase(it);
+  }
+
+  while (entries.size() >= capacity) {
+    entries_by_key.erase(entries.back().key);
+    entries.pop_back();
+  }
+
+  entries.push_front({key, std::move(catalog_state), std::move(prepared)});
+  entries_by_key[key] = entries.begin();
+}
+
+} // namespace ui
+} // namespace duckdb
@@ -0,0 +1,128 @@
+#include "remote_client_pool.hpp"
+
+#define CPPHTTPLIB_OPENSSL_SUPPORT
+#include "httplib.hpp"
+
+namespace httplib = duckdb_httplib_openssl;
+
+namespace duckdb {
+namespace ui {
+
+// Index of the pool in the application data of the SSL contexts of its
+// clients, so the callbacks can find it.
+static int GetPoolIndex() {
+  static const int index =
+      SSL_CTX_get_ex_new_index(0, nullptr, nullptr, nullptr, nullptr);
+  return index;
+}
+
+static RemoteClientPool *GetPool(const SSL *ssl) {
+  return static_cast<RemoteClientPool *>(
+      SSL_CTX_get_ex_data(SSL_get_SSL_CTX(ssl), GetPoolIndex()));
+}
+
+RemoteClientPool::RemoteClientPool(
+    std::string _remote_url, idx_t _max_idle_clients,
+    std::function<void(httplib::Client &)> _init_client)
+    : remote_url(std::move(_remote_url)), max_idle_clients(_max_idle_clients),
+      init_client(std::move(_init_client)) {}
+
+RemoteClientPool::~RemoteClientPool() {
+  // Connections of idle clients hold their own references to the session.
+  idle_clients.clear();
+  if (session) {
+    SSL_SESSION_free(session);
+  }
+}
+
+unique_ptr<httplib::Client> RemoteClientPool::Acquire() {
+  unique_ptr<httplib::Client> client;
+  {
+    std::lock_guard<std::mutex> guard(mutex);
+    if (stopped) {
+      return nullptr;
+    }
+    if (!idle_clients.empty()) {
+      client = std::move(idle_clients.back());
+      idle_clients.pop_back();
+      clients_in_use.insert(client.get());
+      return client;
+    }
+  }
+  client = CreateClient();
+  std::lock_guard<std::mutex> guard(mutex);
+  if (stopped) {
+    return nullptr;
+  }
+  clients_in_use.insert(client.get());
+  return client;
+}
+
+void RemoteClientPool::Release(unique_ptr<httplib::Client> client) {
+  std::lock_guard<std::mutex> guard(mutex);
+  clients_in_use.erase(client.get());
+  if (!stopped && idle_clients.size() < max_idle_clients) {
+    idle_clients.push_back(std::move(client));
+  }
+}
+
+void RemoteClientPool::Stop() {
+  std::lock_guard<std::mutex> guard(mutex);
+  stopped = true;
+  // Client::stop is safe to call while another thread makes a request.
+  for (auto client : clients_in_use) {
+    client->stop();
+  }
+}
+
+unique_ptr<httplib::Client> RemoteClientPool::CreateClient() {
+  auto client = make_uniq<httplib::Client>(remote_url);
+  init_client(*client);
+
+  auto ctx = client->ssl_context();
+  if (!ctx) {
+    return client; // Not HTTPS.
+  }
+  // Sessions are only kept by the pool, not in the context of each client, so
+  // every client can resume them.
+  SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_CLIENT |
+                                          SSL_SESS_CACHE_NO_INTERNAL_STORE);
+  SSL_CTX_set_ex_data(ctx, GetPoolIndex(), this);
+  SSL_CTX_sess_set_new_cb(ctx, OnNewSession);
+  SSL_CTX_set_info_callback(ctx, OnInfo);
+  return client;
+}
+
+void RemoteClientPool::OnInfo(const SSL *ssl, int where, int) {
+  // The start of the first handshake is the last point a session can be
+  // offered: httplib connects its SSL objects right after creating them.
+  if (!(where & SSL_CB_HANDSHAKE_START) || !SSL_in_before(ssl)) {
+    return;
+  }
+  auto pool = GetPool(ssl);
+  if (!pool) {
+    return;
+  }
+  std::lock_guard<std::mutex> guard(pool->mutex);
+  if (pool->session) {
+    // If the server doesn't accept the session, a full handshake is done.
+    SSL_set_session(const_cast<SSL *>(ssl), pool->session);
+  }
+}
+
+int RemoteClientPool::OnNewSession(SSL *ssl, SSL_SESSION *new_session) {
+  auto pool = GetPool(ssl);
+  if (!pool) {
+    return 0;
+  }
+  std::lock_guard<std::mutex> guard(pool->mutex);
+  if (pool->session) {
+    SSL_SESSION_free(pool->session);
+  }
+  // Returning 1 keeps the reference OpenSSL passed in.
+  pool->session = new_session;
+  return 1;
+}
+
+} // namespace ui
+} // namespace duckdb
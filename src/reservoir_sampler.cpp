@@ -0,0 +1,95 @@
+#include "reservoir_sampler.hpp"
+
+#include <cmath>
+
+#include "result_reader.hpp"
+
+namespace duckdb {
+namespace ui {
+
+ReservoirSampler::ReservoirSampler(const vector<LogicalType> &types,
+                                   idx_t _sample_size, int64_t seed,
+                                   idx_t _memory_budget)
+    : sample_size(_sample_size), memory_budget(_memory_budget), random(seed) {
+  reservoir.Initialize(Allocator::DefaultAllocator(), types,
+                       MinValue<idx_t>(sample_size, STANDARD_VECTOR_SIZE));
+}
+
+void ReservoirSampler::Add(DataChunk &chunk) {
+  auto count = chunk.size();
+
+  // Until the reservoir is full, every row is added.
+  if (reservoir.size() < sample_size) {
+    auto rows_to_add = MinValue<idx_t>(count, sample_size - reservoir.size());
+    if (rows_to_add == count) {
+      reservoir.Append(chunk, true);
+      reservoir_size_bytes += ResultReader::GetAllocationSize(chunk);
+    } else {
+      DataChunk prefix;
+      ResultReader::CopyAndSlice(chunk, prefix, 0, rows_to_add);
+      reservoir.Append(prefix, true);
+      reservoir_size_bytes += ResultReader::GetAllocationSize(prefix);
+    }
+    // The default row limit would otherwise keep the whole result in memory.
+    // The rows so far are a uniform sample of themselves, so sampling goes on
+    // with a smaller reservoir.
+    if (reservoir_size_bytes > memory_budget) {
+      sample_size = reservoir.size();
+    }
+    if (reservoir.size() == sample_size) {
+      w = std::exp(std::log(1 - random.NextRandom()) / sample_size);
+      next_row = rows_seen + rows_to_add;
+      SkipRows();
+    }
+  }
+
+  // Then each drawn row replaces a random one in the reservoir.
+  if (sample_size > 0) {
+    SelectionVector selection(1);
+    while (next_row < rows_seen + count) {
+      auto row = next_row - rows_seen;
+      auto position = MinValue<idx_t>(
+          static_cast<idx_t>(random.NextRandom() * sample_size),
+          sample_size - 1);
+      selection.set_index(0, row);
+      for (idx_t i = 0; i < chunk.ColumnCount(); i++) {
+        VectorOperations::Copy(chunk.data[i], reservoir.data[i], selection, 1,
+                               0, position);
+      }
+      w *= std::exp(std::log(1 - random.NextRandom()) / sample_size);
+      next_row++;
+      SkipRows();
+    }
+  }
+
+  rows_seen += count;
+}
+
+void ReservoirSampler::SkipRows() {
+  auto skip = std::floor(std::log(1 - random.NextRandom()) / std::log(1 - w));
+  // Guard against overflow when the odds of another replacement are tiny.
+  if (!(skip < static_cast<double>(NumericLimits<idx_t>::Maximum() / 2))) {
+    next_row = NumericLimits<idx_t>::Maximum();
+    return;
+  }
+  next_row += static_cast<idx_t>(skip);
+}
+
+vector<Chunk> ReservoirSampler::GetChunks() {
+  vector<Chunk> chunks;
+  for (idx_t offset = 0; offset < reservoir.size();
+       offset += STANDARD_VECTOR_SIZE) {
+    auto row_count =
+        MinValue<idx_t>(STANDARD_VECTOR_SIZE, reservoir.size() - offset);
+    DataChunk slice;
+    ResultReader::CopyAndSlice(reservoir, slice, offset, row_count);
+    Chunk chunk;
+    chunk.row_count = static_cast<uint32_t>(row_count);
+    chunk.vectors = std::move(slice.data);
+    chunks.push_back(std::move(chunk));
+  }
+  return chunks;
+}
+
+} // namespace ui
+} // namespace duckdb
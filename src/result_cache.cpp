@@ -0,0 +1,217 @@
+#include "result_cache.hpp"
+
+#include <duckdb/main/attached_database.hpp>
+#include <duckdb/planner/logical_operator_visitor.hpp>
+#include <duckdb/planner/operator/logical_get.hpp>
+#include <duckdb/transaction/duck_transaction_manager.hpp>
+
+#include "utils/helpers.hpp"
+
+namespace duckdb {
+namespace ui {
+
+// Most queries whose cacheability is remembered. All are forgotten once more
+// are seen.
+constexpr idx_t MAX_VERDICT_COUNT = 1024;
+
+bool GetDataState(DatabaseInstance &db, Connection &connection,
+                  DataState &state) {
+  auto &context = *connection.context;
+  connection.BeginTransaction();
+
+  auto trackable = true;
+  const auto &databases = db.GetDatabaseManager().GetDatabases(context);
+  for (const auto &db_ref : databases) {
+#if DUCKDB_VERSION_AT_MOST(1, 3, 2)
+    auto &db_instance = db_ref.get();
+#else
+    auto &db_instance = *db_ref;
+#endif
+    if (db_instance.IsTemporary() || db_instance.IsSystem()) {
+      continue;
+    }
+
+    auto &transaction_manager = db_instance.GetTransactionManager();
+    if (!transaction_manager.IsDuckTransactionManager()) {
+      trackable = false;
+      break;
+    }
+    auto &catalog = db_instance.GetCatalog();
+    state.catalog_state.db_to_catalog_version[db_instance.oid] =
+        catalog.GetCatalogVersion(context);
+    state.db_to_last_commit[db_instance.oid] =
+        transaction_manager.Cast<DuckTransactionManager>().GetLastCommit();
+  }
+
+  connection.Rollback();
+  return trackable;
+}
+
+// Finds what makes a plan's result depend on more than the data of the
+// attached databases.
+class UncacheableOperatorFinder : public LogicalOperatorVisitor {
+public:
+  bool found = false;
+
+  void VisitOperator(LogicalOperator &op) override {
+    // Table functions other than table scans read files, settings or other
+    // state that isn't versioned.
+    if (op.type == LogicalOperatorType::LOGICAL_GET &&
+        op.Cast<LogicalGet>().function.name != "seq_scan") {
+      found = true;
+      return;
+    }
+    LogicalOperatorVisitor::VisitOperator(op);
+  }
+
+protected:
+  // Volatile functions (random(), nextval()) and those only consistent within
+  // a query (now()) give different results each time.
+  void VisitExpression(unique_ptr<Expression> *expression) override {
+    if (!(*expression)->IsConsistent()) {
+      found = true;
+      return;
+    }
+    LogicalOperatorVisitor::VisitExpression(expression);
+  }
+};
+
+bool ResultCache::IsCacheable(Connection &connection, const std::string &sql,
+                              const std::string &key,
+                              const CatalogState &catalog_state) {
+  {
+    std::lock_guard<std::mutex> guard(mutex);
+    auto it = verdicts_by_key.find(key);
+    if (it != verdicts_by_key.end() &&
+        it->second.catalog_state == catalog_state) {
+      return it->second.cacheable;
+    }
+  }
+
+  unique_ptr<LogicalOperator> plan;
+  try {
+    plan = connection.ExtractPlan(sql);
+  } catch (std::exception &) {
+    // Running the query reports the error.
+    return false;
+  }
+  UncacheableOperatorFinder finder;
+  finder.VisitOperator(*plan);
+
+  std::lock_guard<std::mutex> guard(mutex);
+  if (verdicts_by_key.size() >= MAX_VERDICT_COUNT) {
+    verdicts_by_key.clear();
+  }
+  verdicts_by_key[key] = Verdict{catalog_state, !finder.found};
+  return !finder.found;
+}
+
+ResultCache::ResultCache(idx_t _capacity_bytes)
+    : capacity_bytes(_capacity_bytes) {}
+
+// Each part is prefixed with its length, so different combinations of parts
+// can't produce the same key.
+static void AppendKeyPart(std::string &key, const std::string &part) {
+  key += std::to_string(part.size());
+  key += ':';
+  key += part;
+}
+
+std::string ResultCache::MakeKey(const std::string &connection_name,
+                                 const std::string &sql,
+                                 const vector<Value> &parameters,
+                                 const std::string &search_path,
+                                 idx_t result_row_limit, idx_t batch_size,
+                                 idx_t serialization_version) {
+  std::string key;
+  AppendKeyPart(key, connection_name);
+  AppendKeyPart(key, sql);
+  AppendKeyPart(key, std::to_string(parameters.size()));
+  for (auto &parameter : parameters) {
+    // Includes the type, for values whose text alone would be ambiguous.
+    AppendKeyPart(key, parameter.type().ToString());
+    AppendKeyPart(key, parameter.ToSQLString());
+  }
+  AppendKeyPart(key, search_path);
+  AppendKeyPart(key, std::to_string(result_row_limit));
+  AppendKeyPart(key, std::to_string(batch_size));
+  AppendKeyPart(key, std::to_string(serialization_version));
+  return key;
+}
+
+bool ResultCache::Get(const std::string &key, const DataState &data_state,
+                      std::string &result_bytes) {
+  std::lock_guard<std::mutex> guard(mutex);
+  auto it = entries_by_key.find(key);
+  if (it == entries_by_key.end()) {
+    misses++;
+    return false;
+  }
+
+  if (!(it->second->data_state == data_state)) {
+    Erase(it->second);
+    misses++;
+    return false;
+  }
+
+  entries.splice(entries.begin(), entries, it->second);
+  result_bytes = it->second->result_bytes;
+  hits++;
+  return true;
+}
+
+idx_t ResultCache::GetGeneration() {
+  std::lock_guard<std::mutex> guard(mutex);
+  return generation;
+}
+
+void ResultCache::Put(const std::string &key, idx_t put_generation,
+                      DataState data_state, std::string result_bytes) {
+  auto entry_size = key.size() + result_bytes.size();
+  if (entry_size > capacity_bytes) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> guard(mutex);
+  if (put_generation != generation) {
+    return;
+  }
+
+  auto it = entries_by_key.find(key);
+  if (it != entries_by_key.end()) {
+    Erase(it->second);
+  }
+
+  while (size_bytes + entry_size > capacity_bytes) {
+    Erase(std::prev(entries.end()));
+  }
+
+  entries.push_front({key, std::move(data_state), std::move(result_bytes)});
+  entries_by_key[key] = entries.begin();
+  size_bytes += entry_size;
+}
+
+void ResultCache::Clear() {
+  std::lock_guard<std::mutex> guard(mutex);
+  entries.clear();
+  entries_by_key.clear();
+  size_bytes = 0;
+  generation++;
+  // The statements clearing the cache may also change what queries read, e.g.
+  // by replacing a temporary table with a view.
+  verdicts_by_key.clear();
+}
+
+ResultCache::Stats ResultCache::GetStats() {
+  std::lock_guard<std::mutex> guard(mutex);
+  return {hits, misses, entries.size(), size_bytes};
+}
+
+void ResultCache::Erase(std::list<Entry>::iterator it) {
+  size_bytes -= it->key.size() + it->result_bytes.size();
+  entries_by_key.erase(it->key);
+  entries.erase(it);
+}
+
+} // namespace ui
+} // namespace duckdb
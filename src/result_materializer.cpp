@@ -0,0 +1,57 @@
+#include "result_materializer.hpp"
+
+#include "result_reader.hpp"
+
+namespace duckdb {
+namespace ui {
+
+ResultMaterializer::ResultMaterializer(
+    std::string _connection_name, shared_ptr<ResultReader> _reader,
+    std::function<void(const Summary &)> _on_done)
+    : connection_name(std::move(_connection_name)), reader(std::move(_reader)),
+      on_done(std::move(_on_done)) {
+  thread = std::thread(&ResultMaterializer::Run, this);
+}
+
+ResultMaterializer::~ResultMaterializer() { Wait(); }
+
+const std::string &ResultMaterializer::GetConnectionName() const {
+  return connection_name;
+}
+
+bool ResultMaterializer::IsDone() const { return done; }
+
+void ResultMaterializer::Interrupt() { reader->Interrupt(); }
+
+void ResultMaterializer::Wait() {
+  if (thread.joinable()) {
+    thread.join();
+  }
+}
+
+void ResultMaterializer::Run() {
+  Summary summary;
+  summary.table_name = reader->GetResultTableName();
+  try {
+    summary.row_count = reader->FinishResultTable();
+  } catch (std::exception &ex) {
+    ErrorData error(ex);
+    summary.error = error.RawMessage();
+    try {
+      reader->Close();
+    } catch (std::exception &) {
+    }
+  }
+  summary.elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - reader->GetResultTableCreationTime());
+
+  try {
+    on_done(summary);
+  } catch (std::exception &) {
+    // Nothing is left to report this to.
+  }
+  done = true;
+}
+
+} // namespace ui
+} // namespace duckdb
@@ -0,0 +1,264 @@
+#include "result_reader.hpp"
+
+#include "reservoir_sampler.hpp"
+
+#include <duckdb/catalog/catalog.hpp>
+#include <duckdb/main/appender.hpp>
+#include <duckdb/parser/keyword_helper.hpp>
+#include <duckdb/parser/parsed_data/create_table_info.hpp>
+#include <duckdb/transaction/meta_transaction.hpp>
+
+// Most bytes chunks are combined into, so wide rows don't make huge batches.
+#define MAX_BATCH_BYTES (16 * 1024 * 1024)
+// Longest a batch waits for more chunks once it has some rows.
+#define MAX_BATCH_DELAY_MS 100
+
+namespace duckdb {
+namespace ui {
+
+ResultReader::ResultReader(shared_ptr<Connection> _connection,
+                           unique_ptr<QueryResult> _result,
+                           idx_t _result_row_limit,
+                           idx_t _result_table_row_limit)
+    : connection(std::move(_connection)), result(std::move(_result)),
+      column_names_and_types{result->names, result->types},
+      result_row_limit(_result_row_limit),
+      result_table_row_limit(_result_table_row_limit) {}
+
+void ResultReader::CreateResultTable(DatabaseInstance &db,
+                                     const std::string &database_name,
+                                     const std::string &schema_name,
+                                     const std::string &table_name) {
+  auto result_table_info =
+      make_uniq<CreateTableInfo>(database_name, schema_name, table_name);
+  for (idx_t i = 0; i < result->names.size(); i++) {
+    result_table_info->columns.AddColumn(
+        ColumnDefinition(result->names[i], result->types[i]));
+  }
+
+  result_table_name = QualifiedName{database_name, schema_name, table_name};
+  result_table_created_at = std::chrono::steady_clock::now();
+  appender_connection = make_uniq<Connection>(db);
+  auto appender_context = appender_connection->context;
+  appender_context->RunFunctionInTransaction([&] {
+    auto &catalog = Catalog::GetCatalog(*appender_context, database_name);
+    MetaTransaction::Get(*appender_context)
+        .ModifyDatabase(catalog.GetAttached());
+    catalog.CreateTable(*appender_context, std::move(result_table_info));
+  });
+
+  appender = make_uniq<Appender>(*appender_connection, database_name,
+                                 schema_name, table_name);
+  filling_result_table = true;
+}
+
+ColumnNamesAndTypes ResultReader::GetColumnNamesAndTypes() const {
+  return column_names_and_types;
+}
+
+bool ResultReader::HasResultTable() const { return appender != nullptr; }
+
+bool ResultReader::IsFillingResultTable() const {
+  return filling_result_table;
+}
+
+const QualifiedName &ResultReader::GetResultTableName() const {
+  return result_table_name;
+}
+
+std::chrono::steady_clock::time_point
+ResultReader::GetResultTableCreationTime() const {
+  return result_table_created_at;
+}
+
+bool ResultReader::IsExhausted() const { return !result && !remainder; }
+
+void ResultReader::SetCompressVectors(bool _compress_vectors) {
+  compress_vectors = _compress_vectors;
+}
+
+void ResultReader::SetBatchSize(idx_t _batch_size) {
+  batch_size = _batch_size;
+}
+
+void ResultReader::SetBatchFirstChunk(bool _batch_first_chunk) {
+  batch_first_chunk = _batch_first_chunk;
+}
+
+void ResultReader::ResetRowLimit(idx_t row_limit) {
+  result_row_limit = rows_in_result + row_limit;
+}
+
+bool ResultReader::ReadChunk(Chunk &chunk) {
+  if (rows_in_result >= result_row_limit) {
+    return false;
+  }
+
+  auto rows_left = result_row_limit - rows_in_result;
+  auto fetched = rows_in_result == 0 && !batch_first_chunk
+                     ? FetchAndAppend()
+                     : FetchBatch(rows_left);
+  if (!fetched) {
+    return false;
+  }
+
+  DataChunk *chunk_to_add = fetched.get();
+  DataChunk chunk_prefix;
+  if (fetched->size() > rows_left) {
+    CopyAndSlice(*fetched, chunk_prefix, 0, rows_left);
+    chunk_to_add = &chunk_prefix;
+    // Keep the rest, in case the row limit is raised later.
+    remainder = make_uniq<DataChunk>();
+    CopyAndSlice(*fetched, *remainder, rows_left, fetched->size() - rows_left);
+  }
+  chunk.row_count = static_cast<uint32_t>(chunk_to_add->size());
+  chunk.vectors = std::move(chunk_to_add->data);
+  chunk.compress_vectors = compress_vectors;
+  rows_in_result += chunk_to_add->size();
+  return true;
+}
+
+bool ResultReader::ReadSample(ReservoirSampler &sampler,
+                              const std::function<bool()> &should_stop) {
+  while (auto fetched = FetchAndAppend()) {
+    sampler.Add(*fetched);
+    if (should_stop()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+idx_t ResultReader::FinishResultTable() {
+  // The rows left over from the response are already in the result table.
+  remainder.reset();
+  while (appender && rows_appended < result_table_row_limit &&
+         FetchAndAppend()) {
+  }
+  Close();
+  return rows_appended;
+}
+
+unique_ptr<DataChunk> ResultReader::FetchBatch(idx_t max_rows) {
+  auto fetched = FetchAndAppend();
+  auto target_rows = MinValue(batch_size, max_rows);
+  if (!fetched || fetched->size() >= target_rows) {
+    return fetched;
+  }
+
+  // Results that fit in one chunk are handed out as fetched, keeping their
+  // compressed vectors. Combining chunks flattens them.
+  unique_ptr<DataChunk> batch;
+  idx_t batch_bytes = 0;
+  auto deadline = std::chrono::steady_clock::now() +
+                  std::chrono::milliseconds(MAX_BATCH_DELAY_MS);
+  while (fetched) {
+    if (!batch) {
+      auto next = FetchAndAppend();
+      if (!next) {
+        return fetched;
+      }
+      batch = make_uniq<DataChunk>();
+      // Grows as chunks are appended, rather than reserving the whole batch
+      // up front for a result that may turn out to be small.
+      batch->Initialize(Allocator::DefaultAllocator(), fetched->GetTypes());
+      batch->Append(*fetched, true);
+      batch_bytes += GetAllocationSize(*fetched);
+      fetched = std::move(next);
+    }
+    batch->Append(*fetched, true);
+    batch_bytes += GetAllocationSize(*fetched);
+    if (batch->size() >= target_rows || batch_bytes >= MAX_BATCH_BYTES ||
+        std::chrono::steady_clock::now() >= deadline) {
+      break;
+    }
+    fetched = FetchAndAppend();
+  }
+  return batch;
+}
+
+unique_ptr<DataChunk> ResultReader::FetchAndAppend() {
+  // Rows left over from a chunk that was cut off by the row limit come first.
+  // They have already been appended to the result table.
+  if (remainder) {
+    return std::move(remainder);
+  }
+  if (!result) {
+    return nullptr;
+  }
+
+  // Fetch (unlike FetchRaw) flattens the chunk, which would lose compressed
+  // vectors. Everything reading chunks handles any vector type.
+  auto fetched = result->FetchRaw();
+  if (!fetched) {
+    if (result->HasError()) {
+      result->ThrowError();
+    }
+    result.reset();
+    return nullptr;
+  }
+
+  if (appender && rows_appended < result_table_row_limit) {
+    DataChunk *chunk_to_append = fetched.get();
+    DataChunk chunk_prefix;
+    auto rows_left = result_table_row_limit - rows_appended;
+    if (fetched->size() > rows_left) {
+      CopyAndSlice(*fetched, chunk_prefix, 0, rows_left);
+      chunk_to_append = &chunk_prefix;
+    }
+    appender->AppendDataChunk(*chunk_to_append);
+    rows_appended += chunk_to_append->size();
+  }
+  return fetched;
+}
+
+void ResultReader::Interrupt() { connection->Interrupt(); }
+
+void ResultReader::Close() {
+  remainder.reset();
+  result.reset();
+  if (appender) {
+    auto appender_to_close = std::move(appender);
+    appender_to_close->Close();
+  }
+  appender_connection.reset();
+  filling_result_table = false;
+}
+
+void ResultReader::Abort() {
+  remainder.reset();
+  result.reset();
+  if (appender) {
+    auto appender_to_close = std::move(appender);
+    try {
+      appender_to_close->Close();
+    } catch (std::exception &) {
+      // The table is dropped below anyway.
+    }
+    appender_connection->Query(StringUtil::Format(
+        "DROP TABLE IF EXISTS %s.%s.%s",
+        KeywordHelper::WriteOptionallyQuoted(result_table_name.catalog),
+        KeywordHelper::WriteOptionallyQuoted(result_table_name.schema),
+        KeywordHelper::WriteOptionallyQuoted(result_table_name.name)));
+  }
+  appender_connection.reset();
+  filling_result_table = false;
+}
+
+void ResultReader::CopyAndSlice(DataChunk &source, DataChunk &target,
+                                idx_t offset, idx_t row_count) {
+  target.InitializeEmpty(source.GetTypes());
+  target.Reference(source);
+  target.Slice(offset, row_count);
+}
+
+idx_t ResultReader::GetAllocationSize(DataChunk &chunk) {
+  idx_t size = 0;
+  for (auto &vector : chunk.data) {
+    size += vector.GetAllocationSize(chunk.size());
+  }
+  return size;
+}
+
+} // namespace ui
+} // namespace duckdb
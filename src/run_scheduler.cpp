@@ -0,0 +1,178 @@
+#include "run_scheduler.hpp"
+
+namespace duckdb {
+namespace ui {
+
+RunScheduler::Ticket::Ticket(RunScheduler &_scheduler,
+                             std::string _connection_name)
+    : scheduler(_scheduler), connection_name(std::move(_connection_name)) {}
+
+RunScheduler::Ticket::~Ticket() { scheduler.Release(connection_name); }
+
+RunScheduler::RunScheduler(idx_t _max_running, idx_t _max_queued)
+    : max_running(MaxValue<idx_t>(_max_running, 1)), max_queued(_max_queued) {}
+
+RunScheduler::Priority
+RunScheduler::GetPriority(const std::string &priority,
+                          const std::string &description) {
+  if (!priority.empty()) {
+    return StringUtil::CIEquals(priority, "background")
+               ? Priority::BACKGROUND
+               : Priority::INTERACTIVE;
+  }
+  auto lower_description = StringUtil::Lower(description);
+  for (auto keyword : {"background", "prefetch", "refresh"}) {
+    if (StringUtil::Contains(lower_description, keyword)) {
+      return Priority::BACKGROUND;
+    }
+  }
+  return Priority::INTERACTIVE;
+}
+
+unique_ptr<RunScheduler::Ticket>
+RunScheduler::Admit(const std::string &connection_name, Priority priority,
+                    std::string &error) {
+  std::unique_lock<std::mutex> lock(mutex);
+  if (closed) {
+    rejected++;
+    error = "UI server is stopping";
+    return nullptr;
+  }
+
+  // Queued requests are admitted as soon as they can run, so none of them can
+  // run now, and this one doesn't overtake any of them.
+  if (CanRun(connection_name)) {
+    StartRunning(connection_name);
+    admitted++;
+    return make_uniq<Ticket>(*this, connection_name);
+  }
+
+  if (queue.size() >= max_queued) {
+    // An interactive request takes the place of the last queued background
+    // one, if any.
+    auto last = queue.empty() ? nullptr : queue.back();
+    if (priority == Priority::INTERACTIVE && last &&
+        last->priority == Priority::BACKGROUND) {
+      last->error = "Request was displaced by an interactive request";
+      queue.pop_back();
+      rejected++;
+      cv.notify_all();
+    } else {
+      rejected++;
+      error = "Too many queued requests";
+      return nullptr;
+    }
+  }
+
+  Waiter waiter;
+  waiter.connection_name = connection_name;
+  waiter.priority = priority;
+  auto position = queue.begin();
+  while (position != queue.end() && (*position)->priority <= priority) {
+    ++position;
+  }
+  queue.insert(position, &waiter);
+
+  auto queued_at = std::chrono::steady_clock::now();
+  cv.wait(lock, [&] { return waiter.admitted || !waiter.error.empty(); });
+  if (!waiter.admitted) {
+    error = waiter.error;
+    return nullptr;
+  }
+
+  auto wait = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - queued_at);
+  total_wait += wait;
+  max_wait = MaxValue(max_wait, wait);
+  return make_uniq<Ticket>(*this, connection_name);
+}
+
+void RunScheduler::CancelQueued(const std::string &connection_name) {
+  std::lock_guard<std::mutex> guard(mutex);
+  for (auto it = queue.begin(); it != queue.end();) {
+    if ((*it)->connection_name == connection_name) {
+      (*it)->error = "Interrupted";
+      it = queue.erase(it);
+      rejected++;
+    } else {
+      ++it;
+    }
+  }
+  cv.notify_all();
+}
+
+void RunScheduler::Close() {
+  std::lock_guard<std::mutex> guard(mutex);
+  closed = true;
+  for (auto waiter : queue) {
+    waiter->error = "UI server is stopping";
+    rejected++;
+  }
+  queue.clear();
+  cv.notify_all();
+}
+
+void RunScheduler::RecordAborted() {
+  std::lock_guard<std::mutex> guard(mutex);
+  aborted++;
+}
+
+RunScheduler::Stats RunScheduler::GetStats() {
+  std::lock_guard<std::mutex> guard(mutex);
+  return Stats{running,  queue.size(), admitted, rejected,
+               aborted,  total_wait,   max_wait};
+}
+
+bool RunScheduler::CanRun(const std::string &connection_name) {
+  if (running >= max_running) {
+    return false;
+  }
+  // Unnamed connections are never shared, so only the overall limit applies.
+  if (connection_name.empty()) {
+    return true;
+  }
+  auto it = running_by_connection.find(connection_name);
+  return it == running_by_connection.end() || it->second == 0;
+}
+
+void RunScheduler::StartRunning(const std::string &connection_name) {
+  running++;
+  if (!connection_name.empty()) {
+    running_by_connection[connection_name]++;
+  }
+}
+
+void RunScheduler::Release(const std::string &connection_name) {
+  std::lock_guard<std::mutex> guard(mutex);
+  running--;
+  if (!connection_name.empty()) {
+    auto it = running_by_connection.find(connection_name);
+    if (--it->second == 0) {
+      running_by_connection.erase(it);
+    }
+  }
+  AdmitWaiters();
+}
+
+void RunScheduler::AdmitWaiters() {
+  auto admitted_any = false;
+  for (auto it = queue.begin(); it != queue.end() && running < max_running;) {
+    // Requests on busy connections are skipped, so they don't hold up the
+    // requests behind them.
+    if (CanRun((*it)->connection_name)) {
+      StartRunning((*it)->connection_name);
+      (*it)->admitted = true;
+      admitted++;
+      admitted_any = true;
+      it = queue.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  if (admitted_any) {
+    cv.notify_all();
+  }
+}
+
+} // namespace ui
+} // namespace duckdb
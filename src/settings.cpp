@@ -19,4 +19,49 @@ uint32_t GetPollingInterval(const ClientContext &context) {
   return internal::GetSetting<uint32_t>(context,
                                         UI_POLLING_INTERVAL_SETTING_NAME);
 }
+
+uint32_t GetCursorIdleTimeout(const ClientContext &context) {
+  return internal::GetSetting<uint32_t>(context,
+                                        UI_CURSOR_IDLE_TIMEOUT_SETTING_NAME);
+}
+
+uint64_t GetResultCacheSize(const ClientContext &context) {
+  return internal::GetSetting<uint64_t>(context,
+                                        UI_RESULT_CACHE_SIZE_SETTING_NAME);
+}
+
+uint32_t GetMaxConcurrentRuns(const ClientContext &context) {
+  return internal::GetSetting<uint32_t>(context,
+                                        UI_MAX_CONCURRENT_RUNS_SETTING_NAME);
+}
+
+uint32_t GetMaxQueuedRuns(const ClientContext &context) {
+  return internal::GetSetting<uint32_t>(context,
+                                        UI_MAX_QUEUED_RUNS_SETTING_NAME);
+}
+
+uint32_t GetQueryProgressInterval(const ClientContext &context) {
+  return internal::GetSetting<uint32_t>(
+      context, UI_QUERY_PROGRESS_INTERVAL_SETTING_NAME);
+}
+
+uint32_t GetResultBatchSize(const ClientContext &context) {
+  return internal::GetSetting<uint32_t>(context,
+                                        UI_RESULT_BATCH_SIZE_SETTING_NAME);
+}
+
+uint64_t GetResultMemoryBudget(const ClientContext &context) {
+  return internal::GetSetting<uint64_t>(context,
+                                        UI_RESULT_MEMORY_BUDGET_SETTING_NAME);
+}
+
+uint64_t GetAssetCacheSize(const ClientContext &context) {
+  return internal::GetSetting<uint64_t>(context,
+                                        UI_ASSET_CACHE_SIZE_SETTING_NAME);
+}
+
+uint64_t GetAssetMemoryCacheSize(const ClientContext &context) {
+  return internal::GetSetting<uint64_t>(
+      context, UI_ASSET_MEMORY_CACHE_SIZE_SETTING_NAME);
+}
 } // namespace duckdb
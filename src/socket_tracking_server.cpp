@@ -0,0 +1,37 @@
+#include "socket_tracking_server.hpp"
+
+namespace duckdb {
+namespace ui {
+
+static thread_local httplib::socket_t current_socket = INVALID_SOCKET;
+
+httplib::socket_t SocketTrackingServer::GetCurrentSocket() {
+  return current_socket;
+}
+
+bool SocketTrackingServer::IsClientConnected(httplib::socket_t sock) {
+  return sock == INVALID_SOCKET || httplib::detail::is_socket_alive(sock);
+}
+
+// Same as httplib::Server::process_and_close_socket, which is private, apart
+// from recording the socket.
+bool SocketTrackingServer::process_and_close_socket(httplib::socket_t sock) {
+  current_socket = sock;
+  auto ret = httplib::detail::process_server_socket(
+      svr_sock_, sock, keep_alive_max_count_, keep_alive_timeout_sec_,
+      read_timeout_sec_, read_timeout_usec_, write_timeout_sec_,
+      write_timeout_usec_,
+      [this](httplib::Stream &strm, bool close_connection,
+             bool &connection_closed) {
+        return process_request(strm, close_connection, connection_closed,
+                               nullptr);
+      });
+  current_socket = INVALID_SOCKET;
+
+  httplib::detail::shutdown_socket(sock);
+  httplib::detail::close_socket(sock);
+  return ret;
+}
+
+} // namespace ui
+} // namespace duckdb
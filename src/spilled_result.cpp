@@ -0,0 +1,88 @@
+#include "spilled_result.hpp"
+
+#include "column_profiler.hpp"
+
+#include <duckdb/storage/buffer_manager.hpp>
+
+namespace duckdb {
+namespace ui {
+
+SpilledResult::SpilledResult(ClientContext &context, SuccessResult &&result,
+                             unique_ptr<ColumnProfiler> _profiler)
+    : column_names_and_types(std::move(result.column_names_and_types)),
+      collection(BufferManager::GetBufferManager(context),
+                 column_names_and_types.types),
+      profiler(std::move(_profiler)) {
+  for (auto &chunk : result.chunks) {
+    AppendToCollection(chunk);
+  }
+  result.chunks.clear();
+}
+
+SpilledResult::~SpilledResult() = default;
+
+void SpilledResult::Append(Chunk &chunk) {
+  if (profiler) {
+    profiler->Update(chunk);
+  }
+  AppendToCollection(chunk);
+}
+
+void SpilledResult::AppendToCollection(Chunk &chunk) {
+  compress_vectors = chunk.compress_vectors;
+  DataChunk data_chunk;
+  data_chunk.InitializeEmpty(column_names_and_types.types);
+  for (idx_t i = 0; i < chunk.vectors.size(); i++) {
+    data_chunk.data[i].Reference(chunk.vectors[i]);
+  }
+  data_chunk.SetCardinality(chunk.row_count);
+  collection.Append(data_chunk);
+}
+
+void SpilledResult::SetCursorId(const std::string &_cursor_id) {
+  cursor_id = _cursor_id;
+}
+
+// Laid out like SuccessResult, with the chunks read back from the collection.
+// The histograms of the profiles need every chunk, so they are filled as the
+// chunks are written.
+void SpilledResult::Serialize(Serializer &serializer) const {
+  serializer.WriteProperty(100, "success", true);
+  serializer.WriteProperty(101, "column_names_and_types",
+                           column_names_and_types);
+
+  ColumnDataScanState scan_state;
+  collection.InitializeScan(scan_state);
+  DataChunk scan_chunk;
+  collection.InitializeScanChunk(scan_chunk);
+  serializer.WriteList(
+      102, "chunks", collection.ChunkCount(),
+      [&](Serializer::List &list, idx_t) {
+        collection.Scan(scan_state, scan_chunk);
+        Chunk chunk;
+        chunk.row_count = static_cast<uint32_t>(scan_chunk.size());
+        for (auto &vector : scan_chunk.data) {
+          chunk.vectors.emplace_back(vector);
+        }
+        chunk.compress_vectors = compress_vectors;
+        if (profiler) {
+          profiler->AddToHistograms(chunk);
+        }
+        list.WriteElement(chunk);
+      });
+
+  serializer.WritePropertyWithDefault(103, "cursor_id", cursor_id);
+  vector<ColumnProfile> column_profiles;
+  if (profiler) {
+    column_profiles = profiler->Finish();
+  }
+  if (!column_profiles.empty()) {
+    serializer.WriteList(104, "column_profiles", column_profiles.size(),
+                         [&](Serializer::List &list, idx_t i) {
+                           list.WriteElement(column_profiles[i]);
+                         });
+  }
+}
+
+} // namespace ui
+} // namespace duckdb
@@ -2,6 +2,12 @@
 
 #include <duckdb/main/database.hpp>
 
+#include "prepared_statement_cache.hpp"
+#include "result_reader.hpp"
+
+// Number of prepared statements kept per named connection.
+#define PREPARED_STATEMENT_CACHE_CAPACITY 64
+
 namespace duckdb {
 
 UIStorageExtensionInfo &
@@ -57,4 +63,93 @@ shared_ptr<Connection> UIStorageExtensionInfo::FindOrCreateConnection(
   return new_con;
 }
 
+void UIStorageExtensionInfo::PutCursor(const std::string &connection_name,
+                                       const std::string &cursor_id,
+                                       shared_ptr<ui::ResultReader> reader,
+                                       std::chrono::milliseconds idle_timeout) {
+  EvictIdleCursors();
+
+  Cursor cursor{cursor_id, std::move(reader),
+                std::chrono::steady_clock::now() + idle_timeout};
+  shared_ptr<ui::ResultReader> replaced_reader;
+  {
+    std::lock_guard<std::mutex> guard(cursors_mutex);
+    auto &entry = cursors[connection_name];
+    replaced_reader = std::move(entry.reader);
+    entry = std::move(cursor);
+  }
+  // Readers are released outside the lock, because closing them can take a
+  // while (e.g. flushing a result table).
+  if (replaced_reader) {
+    replaced_reader->Close();
+  }
+}
+
+shared_ptr<ui::ResultReader>
+UIStorageExtensionInfo::TakeCursor(const std::string &connection_name,
+                                   const std::string &cursor_id) {
+  std::lock_guard<std::mutex> guard(cursors_mutex);
+  auto it = cursors.find(connection_name);
+  if (it == cursors.end() || it->second.id != cursor_id ||
+      it->second.expires_at < std::chrono::steady_clock::now()) {
+    return nullptr;
+  }
+  auto reader = std::move(it->second.reader);
+  cursors.erase(it);
+  return reader;
+}
+
+void UIStorageExtensionInfo::CloseCursor(const std::string &connection_name) {
+  shared_ptr<ui::ResultReader> reader;
+  {
+    std::lock_guard<std::mutex> guard(cursors_mutex);
+    auto it = cursors.find(connection_name);
+    if (it == cursors.end()) {
+      return;
+    }
+    reader = std::move(it->second.reader);
+    cursors.erase(it);
+  }
+  reader->Close();
+}
+
+void UIStorageExtensionInfo::EvictIdleCursors() {
+  std::vector<shared_ptr<ui::ResultReader>> evicted;
+  {
+    std::lock_guard<std::mutex> guard(cursors_mutex);
+    auto now = std::chrono::steady_clock::now();
+    for (auto it = cursors.begin(); it != cursors.end();) {
+      if (it->second.expires_at < now) {
+        evicted.push_back(std::move(it->second.reader));
+        it = cursors.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+  for (auto &reader : evicted) {
+    try {
+      reader->Close();
+    } catch (std::exception &) {
+      // The cursor is gone either way; nobody is left to report this to.
+    }
+  }
+}
+
+shared_ptr<ui::PreparedStatementCache>
+UIStorageExtensionInfo::GetPreparedStatementCache(
+    const std::string &connection_name) {
+  if (connection_name.empty()) {
+    return nullptr;
+  }
+
+  std::lock_guard<std::mutex> guard(prepared_statement_caches_mutex);
+  auto &cache = prepared_statement_caches[connection_name];
+  if (!cache) {
+    cache = make_shared_ptr<ui::PreparedStatementCache>(
+        PREPARED_STATEMENT_CACHE_CAPACITY);
+  }
+  return cache;
+}
+
 } // namespace duckdb
@@ -75,6 +75,163 @@ void IsUIStartedTableFunc(ClientContext &context, TableFunctionInput &input,
   output.SetValue(0, 0, ui::HttpServer::Started());
 }
 
+unique_ptr<FunctionData> ResultCacheStatsBind(ClientContext &,
+                                              TableFunctionBindInput &,
+                                              vector<LogicalType> &out_types,
+                                              vector<std::string> &out_names) {
+  out_names = {"hits", "misses", "entry_count", "size_bytes"};
+  out_types = {LogicalType::UBIGINT, LogicalType::UBIGINT,
+               LogicalType::UBIGINT, LogicalType::UBIGINT};
+  return nullptr;
+}
+
+void ResultCacheStatsTableFunc(ClientContext &context,
+                               TableFunctionInput &input, DataChunk &output) {
+  if (!internal::ShouldRun(input)) {
+    return;
+  }
+
+  if (!ui::HttpServer::Started()) {
+    throw ExecutorException("UI server not started");
+  }
+
+  auto stats = ui::HttpServer::GetInstance(context)->GetResultCacheStats();
+  output.SetCardinality(1);
+  output.SetValue(0, 0, Value::UBIGINT(stats.hits));
+  output.SetValue(1, 0, Value::UBIGINT(stats.misses));
+  output.SetValue(2, 0, Value::UBIGINT(stats.entry_count));
+  output.SetValue(3, 0, Value::UBIGINT(stats.size_bytes));
+}
+
+unique_ptr<FunctionData> RunSchedulerStatsBind(ClientContext &,
+                                               TableFunctionBindInput &,
+                                               vector<LogicalType> &out_types,
+                                               vector<std::string> &out_names) {
+  out_names = {"running", "queued",          "admitted",   "rejected",
+               "aborted", "average_wait_ms", "max_wait_ms"};
+  out_types = {LogicalType::UBIGINT, LogicalType::UBIGINT,
+               LogicalType::UBIGINT, LogicalType::UBIGINT,
+               LogicalType::UBIGINT, LogicalType::DOUBLE,
+               LogicalType::DOUBLE};
+  return nullptr;
+}
+
+void RunSchedulerStatsTableFunc(ClientContext &context,
+                                TableFunctionInput &input, DataChunk &output) {
+  if (!internal::ShouldRun(input)) {
+    return;
+  }
+
+  if (!ui::HttpServer::Started()) {
+    throw ExecutorException("UI server not started");
+  }
+
+  auto stats = ui::HttpServer::GetInstance(context)->GetRunSchedulerStats();
+  auto average_wait_ms =
+      stats.admitted == 0
+          ? 0.0
+          : stats.total_wait.count() / 1000.0 / stats.admitted;
+  output.SetCardinality(1);
+  output.SetValue(0, 0, Value::UBIGINT(stats.running));
+  output.SetValue(1, 0, Value::UBIGINT(stats.queued));
+  output.SetValue(2, 0, Value::UBIGINT(stats.admitted));
+  output.SetValue(3, 0, Value::UBIGINT(stats.rejected));
+  output.SetValue(4, 0, Value::UBIGINT(stats.aborted));
+  output.SetValue(5, 0, Value::DOUBLE(average_wait_ms));
+  output.SetValue(6, 0, Value::DOUBLE(stats.max_wait.count() / 1000.0));
+}
+
+unique_ptr<FunctionData>
+AssetMemoryCacheStatsBind(ClientContext &, TableFunctionBindInput &,
+                          vector<LogicalType> &out_types,
+                          vector<std::string> &out_names) {
+  out_names = {"hits",       "misses",       "hit_ratio",  "entry_count",
+               "size_bytes", "bytes_served", "bytes_saved"};
+  out_types = {LogicalType::UBIGINT, LogicalType::UBIGINT,
+               LogicalType::DOUBLE,  LogicalType::UBIGINT,
+               LogicalType::UBIGINT, LogicalType::UBIGINT,
+               LogicalType::UBIGINT};
+  return nullptr;
+}
+
+void AssetMemoryCacheStatsTableFunc(ClientContext &context,
+                                    TableFunctionInput &input,
+                                    DataChunk &output) {
+  if (!internal::ShouldRun(input)) {
+    return;
+  }
+
+  if (!ui::HttpServer::Started()) {
+    throw ExecutorException("UI server not started");
+  }
+
+  auto stats = ui::HttpServer::GetInstance(context)->GetAssetMemoryCacheStats();
+  auto lookups = stats.hits + stats.misses;
+  auto hit_ratio =
+      lookups == 0 ? 0.0 : static_cast<double>(stats.hits) / lookups;
+  output.SetCardinality(1);
+  output.SetValue(0, 0, Value::UBIGINT(stats.hits));
+  output.SetValue(1, 0, Value::UBIGINT(stats.misses));
+  output.SetValue(2, 0, Value::DOUBLE(hit_ratio));
+  output.SetValue(3, 0, Value::UBIGINT(stats.entry_count));
+  output.SetValue(4, 0, Value::UBIGINT(stats.size_bytes));
+  output.SetValue(5, 0, Value::UBIGINT(stats.bytes_served));
+  output.SetValue(6, 0, Value::UBIGINT(stats.bytes_saved));
+}
+
+struct LoadBundleBindData : public TableFunctionData {
+  // Bundle to install. Empty to load the installed one.
+  std::string source_path;
+};
+
+unique_ptr<FunctionData> LoadBundleBind(ClientContext &,
+                                        TableFunctionBindInput &input,
+                                        vector<LogicalType> &out_types,
+                                        vector<std::string> &out_names) {
+  auto bind_data = make_uniq<LoadBundleBindData>();
+  if (!input.inputs.empty() && !input.inputs[0].IsNull()) {
+    bind_data->source_path = input.inputs[0].GetValue<std::string>();
+  }
+  out_names = {"version", "asset_count", "size_bytes"};
+  out_types = {LogicalType::VARCHAR, LogicalType::UBIGINT,
+               LogicalType::UBIGINT};
+  return std::move(bind_data);
+}
+
+void LoadBundleTableFunc(ClientContext &context, TableFunctionInput &input,
+                         DataChunk &output) {
+  if (!internal::ShouldRun(input)) {
+    return;
+  }
+
+  auto &bind_data = input.bind_data->Cast<LoadBundleBindData>();
+  auto bundle = ui::HttpServer::LoadAssetBundle(context, bind_data.source_path);
+  output.SetCardinality(1);
+  output.SetValue(0, 0, Value(bundle->GetVersion()));
+  output.SetValue(1, 0, Value::UBIGINT(bundle->GetAssetCount()));
+  output.SetValue(2, 0, Value::UBIGINT(bundle->GetSizeBytes()));
+}
+
+unique_ptr<FunctionData> UnloadBundleBind(ClientContext &,
+                                          TableFunctionBindInput &,
+                                          vector<LogicalType> &out_types,
+                                          vector<std::string> &out_names) {
+  out_names = {"removed_count"};
+  out_types = {LogicalType::UBIGINT};
+  return nullptr;
+}
+
+void UnloadBundleTableFunc(ClientContext &context, TableFunctionInput &input,
+                           DataChunk &output) {
+  if (!internal::ShouldRun(input)) {
+    return;
+  }
+
+  auto removed_count = ui::HttpServer::UnloadAssetBundle(context);
+  output.SetCardinality(1);
+  output.SetValue(0, 0, Value::UBIGINT(removed_count));
+}
+
 void InitStorageExtension(duckdb::DatabaseInstance &db) {
   auto &config = db.config;
   auto ext = duckdb::make_uniq<duckdb::StorageExtension>();
@@ -126,6 +283,95 @@ static void LoadInternal(DatabaseInstance &instance) {
         LogicalType::UINTEGER, Value::UINTEGER(def));
   }
 
+  {
+    auto def = GetEnvOrDefaultInt(UI_CURSOR_IDLE_TIMEOUT_SETTING_NAME,
+                                  UI_CURSOR_IDLE_TIMEOUT_SETTING_DEFAULT);
+    config.AddExtensionOption(
+        UI_CURSOR_IDLE_TIMEOUT_SETTING_NAME,
+        "Period of time after which an unused result cursor is closed (in ms)",
+        LogicalType::UINTEGER, Value::UINTEGER(def));
+  }
+
+  {
+    auto def = GetEnvOrDefaultInt(UI_RESULT_CACHE_SIZE_SETTING_NAME,
+                                  UI_RESULT_CACHE_SIZE_SETTING_DEFAULT);
+    config.AddExtensionOption(
+        UI_RESULT_CACHE_SIZE_SETTING_NAME,
+        "Maximum size of the UI server's query result cache (in bytes)",
+        LogicalType::UBIGINT, Value::UBIGINT(def));
+  }
+
+  {
+    auto def = GetEnvOrDefaultInt(UI_MAX_CONCURRENT_RUNS_SETTING_NAME,
+                                  UI_MAX_CONCURRENT_RUNS_SETTING_DEFAULT);
+    config.AddExtensionOption(
+        UI_MAX_CONCURRENT_RUNS_SETTING_NAME,
+        "Maximum number of queries the UI server runs at once",
+        LogicalType::UINTEGER, Value::UINTEGER(def));
+  }
+
+  {
+    auto def = GetEnvOrDefaultInt(UI_MAX_QUEUED_RUNS_SETTING_NAME,
+                                  UI_MAX_QUEUED_RUNS_SETTING_DEFAULT);
+    config.AddExtensionOption(
+        UI_MAX_QUEUED_RUNS_SETTING_NAME,
+        "Maximum number of queries waiting to run in the UI server, beyond "
+        "which new ones are rejected",
+        LogicalType::UINTEGER, Value::UINTEGER(def));
+  }
+
+  {
+    auto def = GetEnvOrDefaultInt(UI_QUERY_PROGRESS_INTERVAL_SETTING_NAME,
+                                  UI_QUERY_PROGRESS_INTERVAL_SETTING_DEFAULT);
+    config.AddExtensionOption(
+        UI_QUERY_PROGRESS_INTERVAL_SETTING_NAME,
+        "Minimum period of time between the progress events of a running "
+        "query (in ms). Set to 0 to disable progress events.",
+        LogicalType::UINTEGER, Value::UINTEGER(def));
+  }
+
+  {
+    auto def = GetEnvOrDefaultInt(UI_RESULT_BATCH_SIZE_SETTING_NAME,
+                                  UI_RESULT_BATCH_SIZE_SETTING_DEFAULT);
+    config.AddExtensionOption(
+        UI_RESULT_BATCH_SIZE_SETTING_NAME,
+        "Number of rows the UI server combines result chunks into before "
+        "sending them (at most 1048576). Set to 0 to send chunks as they are "
+        "produced.",
+        LogicalType::UINTEGER, Value::UINTEGER(def));
+  }
+
+  {
+    auto def = GetEnvOrDefaultInt(UI_RESULT_MEMORY_BUDGET_SETTING_NAME,
+                                  UI_RESULT_MEMORY_BUDGET_SETTING_DEFAULT);
+    config.AddExtensionOption(
+        UI_RESULT_MEMORY_BUDGET_SETTING_NAME,
+        "Maximum size of the rows the UI server holds in memory for a "
+        "response (in bytes). Rows beyond it are spilled to the temp "
+        "directory, or streamed for Arrow results.",
+        LogicalType::UBIGINT, Value::UBIGINT(def));
+  }
+
+  {
+    auto def = GetEnvOrDefaultInt(UI_ASSET_CACHE_SIZE_SETTING_NAME,
+                                  UI_ASSET_CACHE_SIZE_SETTING_DEFAULT);
+    config.AddExtensionOption(
+        UI_ASSET_CACHE_SIZE_SETTING_NAME,
+        "Maximum size of the UI assets cached on disk (in bytes). Set to 0 to "
+        "disable the cache.",
+        LogicalType::UBIGINT, Value::UBIGINT(def));
+  }
+
+  {
+    auto def = GetEnvOrDefaultInt(UI_ASSET_MEMORY_CACHE_SIZE_SETTING_NAME,
+                                  UI_ASSET_MEMORY_CACHE_SIZE_SETTING_DEFAULT);
+    config.AddExtensionOption(
+        UI_ASSET_MEMORY_CACHE_SIZE_SETTING_NAME,
+        "Maximum size of the immutable UI assets, and their compressed "
+        "variants, kept in memory (in bytes). Set to 0 to disable the cache.",
+        LogicalType::UBIGINT, Value::UBIGINT(def));
+  }
+
   REGISTER_TF("start_ui", StartUIFunction);
   REGISTER_TF("start_ui_server", StartUIServerFunction);
   REGISTER_TF("stop_ui_server", StopUIServerFunction);
@@ -138,6 +384,63 @@ static void LoadInternal(DatabaseInstance &instance) {
     loader.RegisterFunction(tf);
 #else
     ExtensionUtil::RegisterFunction(instance, tf);
+#endif
+  }
+  {
+    TableFunction tf("ui_result_cache_stats", {}, ResultCacheStatsTableFunc,
+                     ResultCacheStatsBind, RunOnceTableFunctionState::Init);
+#ifdef DUCKDB_CPP_EXTENSION_ENTRY
+    loader.RegisterFunction(tf);
+#else
+    ExtensionUtil::RegisterFunction(instance, tf);
+#endif
+  }
+
+  {
+    TableFunction tf("ui_run_scheduler_stats", {}, RunSchedulerStatsTableFunc,
+                     RunSchedulerStatsBind, RunOnceTableFunctionState::Init);
+#ifdef DUCKDB_CPP_EXTENSION_ENTRY
+    loader.RegisterFunction(tf);
+#else
+    ExtensionUtil::RegisterFunction(instance, tf);
+#endif
+  }
+
+  {
+    TableFunction tf("ui_asset_memory_cache_stats", {},
+                     AssetMemoryCacheStatsTableFunc, AssetMemoryCacheStatsBind,
+                     RunOnceTableFunctionState::Init);
+#ifdef DUCKDB_CPP_EXTENSION_ENTRY
+    loader.RegisterFunction(tf);
+#else
+    ExtensionUtil::RegisterFunction(instance, tf);
+#endif
+  }
+
+  {
+    // ui_load_bundle() loads the installed bundle, ui_load_bundle(path)
+    // installs the one at `path` first.
+    TableFunctionSet tfs("ui_load_bundle");
+    tfs.AddFunction(TableFunction({}, LoadBundleTableFunc, LoadBundleBind,
+                                  RunOnceTableFunctionState::Init));
+    tfs.AddFunction(TableFunction({LogicalType::VARCHAR}, LoadBundleTableFunc,
+                                  LoadBundleBind,
+                                  RunOnceTableFunctionState::Init));
+#ifdef DUCKDB_CPP_EXTENSION_ENTRY
+    loader.RegisterFunction(tfs);
+#else
+    ExtensionUtil::RegisterFunction(instance, tfs);
+#endif
+  }
+
+  {
+    // Removes the installed bundles, going back to the remote UI.
+    TableFunction tf("ui_unload_bundle", {}, UnloadBundleTableFunc,
+                     UnloadBundleBind, RunOnceTableFunctionState::Init);
+#ifdef DUCKDB_CPP_EXTENSION_ENTRY
+    loader.RegisterFunction(tf);
+#else
+    ExtensionUtil::RegisterFunction(instance, tf);
 #endif
   }
 }
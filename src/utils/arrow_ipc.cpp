@@ -0,0 +1,619 @@
+#include "utils/arrow_ipc.hpp"
+
+#include <duckdb/common/arrow/arrow_appender.hpp>
+#include <duckdb/common/arrow/arrow_converter.hpp>
+
+#include <cstring>
+#include <functional>
+
+namespace duckdb {
+namespace ui {
+
+namespace {
+
+// Arrow IPC metadata is stored as flatbuffers. The few tables needed are
+// written by hand, to avoid depending on the flatbuffers library and the
+// generated Arrow schema code.
+//
+// Unlike the flatbuffers library, which builds buffers back to front, tables
+// are written before the objects they refer to, so all offsets point forward.
+
+class FlatBuffer;
+
+// A flatbuffer table, described by its fields. Objects the table refers to are
+// written by callbacks once the table itself has been written.
+struct FlatTable {
+  struct Field {
+    uint16_t id;
+    // Size of a scalar field in bytes, or zero for a reference.
+    uint8_t size;
+    uint64_t scalar;
+    std::function<idx_t(FlatBuffer &)> write_target;
+  };
+  vector<Field> fields;
+
+  template <class T> void AddScalar(uint16_t id, T value) {
+    uint64_t scalar = 0;
+    memcpy(&scalar, &value, sizeof(T));
+    fields.push_back({id, sizeof(T), scalar, nullptr});
+  }
+  void AddReference(uint16_t id,
+                    std::function<idx_t(FlatBuffer &)> write_target) {
+    fields.push_back({id, 0, 0, std::move(write_target)});
+  }
+  void AddString(uint16_t id, std::string value);
+  void AddTable(uint16_t id, FlatTable table);
+  void AddTables(uint16_t id, vector<FlatTable> tables);
+};
+
+// Arrow's FieldNode and Buffer structs, which both consist of two longs.
+struct FlatStruct {
+  int64_t first;
+  int64_t second;
+};
+
+class FlatBuffer {
+public:
+  // Returns the buffer holding `root`, padded to a multiple of 8 bytes.
+  static std::string Finish(const FlatTable &root) {
+    FlatBuffer buffer;
+    buffer.data.resize(sizeof(uint32_t));
+    auto root_position = buffer.WriteTable(root);
+    buffer.WriteAt<uint32_t>(0, root_position);
+    buffer.Align(8);
+    return std::move(buffer.data);
+  }
+
+  idx_t WriteTable(const FlatTable &table) {
+    // Place wider fields first, so they are naturally aligned.
+    vector<const FlatTable::Field *> fields;
+    uint16_t field_count = 0;
+    for (auto &field : table.fields) {
+      fields.push_back(&field);
+      field_count = MaxValue<uint16_t>(field_count, field.id + 1);
+    }
+    std::stable_sort(
+        fields.begin(), fields.end(),
+        [](const FlatTable::Field *a, const FlatTable::Field *b) {
+          return FieldSize(*a) > FieldSize(*b);
+        });
+    vector<uint16_t> field_offsets(fields.size());
+    idx_t table_size = sizeof(int32_t);
+    for (idx_t i = 0; i < fields.size(); i++) {
+      auto size = FieldSize(*fields[i]);
+      table_size = AlignValue(table_size, size);
+      field_offsets[i] = table_size;
+      table_size += size;
+    }
+
+    Align(sizeof(uint16_t));
+    auto vtable_position = data.size();
+    auto vtable_size = sizeof(uint16_t) * (2 + field_count);
+    data.resize(data.size() + vtable_size);
+    WriteAt<uint16_t>(vtable_position, vtable_size);
+    WriteAt<uint16_t>(vtable_position + sizeof(uint16_t), table_size);
+    for (idx_t i = 0; i < fields.size(); i++) {
+      auto entry_position =
+          vtable_position + sizeof(uint16_t) * (2 + fields[i]->id);
+      WriteAt<uint16_t>(entry_position, field_offsets[i]);
+    }
+
+    Align(8);
+    auto table_position = data.size();
+    data.resize(data.size() + table_size);
+    WriteAt<int32_t>(table_position, table_position - vtable_position);
+    for (idx_t i = 0; i < fields.size(); i++) {
+      if (fields[i]->size > 0) {
+        memcpy(&data[table_position + field_offsets[i]], &fields[i]->scalar,
+               fields[i]->size);
+      }
+    }
+    for (idx_t i = 0; i < fields.size(); i++) {
+      if (fields[i]->size == 0) {
+        auto field_position = table_position + field_offsets[i];
+        auto target_position = fields[i]->write_target(*this);
+        WriteAt<uint32_t>(field_position, target_position - field_position);
+      }
+    }
+    return table_position;
+  }
+
+  idx_t WriteString(const std::string &value) {
+    Align(sizeof(uint32_t));
+    auto position = data.size();
+    Append<uint32_t>(value.size());
+    data += value;
+    data.push_back('\0');
+    return position;
+  }
+
+  idx_t WriteTables(const vector<FlatTable> &tables) {
+    Align(sizeof(uint32_t));
+    auto position = data.size();
+    Append<uint32_t>(tables.size());
+    data.resize(data.size() + sizeof(uint32_t) * tables.size());
+    for (idx_t i = 0; i < tables.size(); i++) {
+      auto slot_position = position + sizeof(uint32_t) * (i + 1);
+      auto table_position = WriteTable(tables[i]);
+      WriteAt<uint32_t>(slot_position, table_position - slot_position);
+    }
+    return position;
+  }
+
+  idx_t WriteStructs(const vector<FlatStruct> &structs) {
+    // The elements follow the length and must be aligned to 8 bytes.
+    Align(8);
+    data.resize(data.size() + sizeof(uint32_t));
+    auto position = data.size();
+    Append<uint32_t>(structs.size());
+    for (auto &value : structs) {
+      Append<int64_t>(value.first);
+      Append<int64_t>(value.second);
+    }
+    return position;
+  }
+
+private:
+  static idx_t FieldSize(const FlatTable::Field &field) {
+    return field.size == 0 ? sizeof(uint32_t) : field.size;
+  }
+
+  static idx_t AlignValue(idx_t value, idx_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+  }
+
+  void Align(idx_t alignment) {
+    data.resize(AlignValue(data.size(), alignment));
+  }
+
+  template <class T> void Append(T value) {
+    data.resize(data.size() + sizeof(T));
+    WriteAt<T>(data.size() - sizeof(T), value);
+  }
+
+  template <class T> void WriteAt(idx_t position, T value) {
+    memcpy(&data[position], &value, sizeof(T));
+  }
+
+  std::string data;
+};
+
+void FlatTable::AddString(uint16_t id, std::string value) {
+  AddReference(id, [value](FlatBuffer &buffer) {
+    return buffer.WriteString(value);
+  });
+}
+
+void FlatTable::AddTable(uint16_t id, FlatTable table) {
+  AddReference(id, [table](FlatBuffer &buffer) {
+    return buffer.WriteTable(table);
+  });
+}
+
+void FlatTable::AddTables(uint16_t id, vector<FlatTable> tables) {
+  AddReference(id, [tables](FlatBuffer &buffer) {
+    return buffer.WriteTables(tables);
+  });
+}
+
+// Values of the enums and unions in Arrow's Schema.fbs and Message.fbs.
+constexpr int16_t METADATA_VERSION_V5 = 4;
+
+constexpr uint8_t MESSAGE_HEADER_SCHEMA = 1;
+constexpr uint8_t MESSAGE_HEADER_RECORD_BATCH = 3;
+
+enum class ArrowIPCType : uint8_t {
+  NULL_TYPE = 1,
+  INT = 2,
+  FLOATING_POINT = 3,
+  BINARY = 4,
+  UTF8 = 5,
+  BOOL = 6,
+  DECIMAL = 7,
+  DATE = 8,
+  TIME = 9,
+  TIMESTAMP = 10,
+  INTERVAL = 11,
+  LIST = 12,
+  STRUCT = 13,
+  FIXED_SIZE_BINARY = 15,
+  FIXED_SIZE_LIST = 16,
+  MAP = 17,
+  DURATION = 18,
+  LARGE_BINARY = 19,
+  LARGE_UTF8 = 20,
+  LARGE_LIST = 21
+};
+
+constexpr int16_t TIME_UNIT_SECOND = 0;
+constexpr int16_t TIME_UNIT_MILLISECOND = 1;
+constexpr int16_t TIME_UNIT_MICROSECOND = 2;
+constexpr int16_t TIME_UNIT_NANOSECOND = 3;
+
+// Layout of an array of a given Arrow type, derived from its format string
+// (see the Arrow C data interface).
+struct ArrowLayout {
+  ArrowIPCType type;
+  FlatTable type_table;
+  // Width of the values in bytes, if they are fixed-width. Zero for booleans,
+  // which are stored as bits, and for types without a values buffer.
+  idx_t value_width = 0;
+  // Width of the offsets, for variable-length and list types.
+  idx_t offset_width = 0;
+  // Whether the values are variable-length, in a buffer after the offsets.
+  bool variable_length = false;
+};
+
+int16_t ParseTimeUnit(char unit, const std::string &format) {
+  switch (unit) {
+  case 's':
+    return TIME_UNIT_SECOND;
+  case 'm':
+    return TIME_UNIT_MILLISECOND;
+  case 'u':
+    return TIME_UNIT_MICROSECOND;
+  case 'n':
+    return TIME_UNIT_NANOSECOND;
+  default:
+    throw NotImplementedException("Unsupported Arrow format: %s", format);
+  }
+}
+
+ArrowLayout GetArrowLayout(const std::string &format) {
+  ArrowLayout layout;
+  auto fixed = [&](ArrowIPCType type, idx_t width) {
+    layout.type = type;
+    layout.value_width = width;
+  };
+  auto integer = [&](idx_t width, bool is_signed) {
+    fixed(ArrowIPCType::INT, width);
+    layout.type_table.AddScalar<int32_t>(0, width * 8);
+    layout.type_table.AddScalar<uint8_t>(1, is_signed);
+  };
+  auto floating_point = [&](idx_t width, int16_t precision) {
+    fixed(ArrowIPCType::FLOATING_POINT, width);
+    layout.type_table.AddScalar<int16_t>(0, precision);
+  };
+  auto variable = [&](ArrowIPCType type, idx_t offset_width) {
+    layout.type = type;
+    layout.offset_width = offset_width;
+    layout.variable_length = true;
+  };
+  auto list = [&](ArrowIPCType type, idx_t offset_width) {
+    layout.type = type;
+    layout.offset_width = offset_width;
+  };
+
+  if (format == "n") {
+    layout.type = ArrowIPCType::NULL_TYPE;
+  } else if (format == "b") {
+    layout.type = ArrowIPCType::BOOL;
+  } else if (format == "c" || format == "C") {
+    integer(1, format == "c");
+  } else if (format == "s" || format == "S") {
+    integer(2, format == "s");
+  } else if (format == "i" || format == "I") {
+    integer(4, format == "i");
+  } else if (format == "l" || format == "L") {
+    integer(8, format == "l");
+  } else if (format == "e") {
+    floating_point(2, 0);
+  } else if (format == "f") {
+    floating_point(4, 1);
+  } else if (format == "g") {
+    floating_point(8, 2);
+  } else if (format == "z") {
+    variable(ArrowIPCType::BINARY, 4);
+  } else if (format == "Z") {
+    variable(ArrowIPCType::LARGE_BINARY, 8);
+  } else if (format == "u") {
+    variable(ArrowIPCType::UTF8, 4);
+  } else if (format == "U") {
+    variable(ArrowIPCType::LARGE_UTF8, 8);
+  } else if (StringUtil::StartsWith(format, "d:")) {
+    // d:precision,scale[,bitWidth]
+    auto parts = StringUtil::Split(format.substr(2), ',');
+    if (parts.size() < 2) {
+      throw NotImplementedException("Unsupported Arrow format: %s", format);
+    }
+    int32_t bit_width = parts.size() > 2 ? std::stoi(parts[2]) : 128;
+    fixed(ArrowIPCType::DECIMAL, bit_width / 8);
+    layout.type_table.AddScalar<int32_t>(0, std::stoi(parts[0]));
+    layout.type_table.AddScalar<int32_t>(1, std::stoi(parts[1]));
+    layout.type_table.AddScalar<int32_t>(2, bit_width);
+  } else if (StringUtil::StartsWith(format, "w:")) {
+    int32_t byte_width = std::stoi(format.substr(2));
+    fixed(ArrowIPCType::FIXED_SIZE_BINARY, byte_width);
+    layout.type_table.AddScalar<int32_t>(0, byte_width);
+  } else if (format == "tdD" || format == "tdm") {
+    fixed(ArrowIPCType::DATE, format == "tdD" ? 4 : 8);
+    layout.type_table.AddScalar<int16_t>(0, format == "tdD" ? 0 : 1);
+  } else if (format.size() == 3 && StringUtil::StartsWith(format, "tt")) {
+    auto unit = ParseTimeUnit(format[2], format);
+    int32_t bit_width = unit <= TIME_UNIT_MILLISECOND ? 32 : 64;
+    fixed(ArrowIPCType::TIME, bit_width / 8);
+    layout.type_table.AddScalar<int16_t>(0, unit);
+    layout.type_table.AddScalar<int32_t>(1, bit_width);
+  } else if (format.size() >= 4 && StringUtil::StartsWith(format, "ts") &&
+             format[3] == ':') {
+    fixed(ArrowIPCType::TIMESTAMP, 8);
+    layout.type_table.AddScalar<int16_t>(0, ParseTimeUnit(format[2], format));
+    auto timezone = format.substr(4);
+    if (!timezone.empty()) {
+      layout.type_table.AddString(1, timezone);
+    }
+  } else if (format.size() == 3 && StringUtil::StartsWith(format, "tD")) {
+    fixed(ArrowIPCType::DURATION, 8);
+    layout.type_table.AddScalar<int16_t>(0, ParseTimeUnit(format[2], format));
+  } else if (format == "tiM") {
+    fixed(ArrowIPCType::INTERVAL, 4);
+    layout.type_table.AddScalar<int16_t>(0, 0);
+  } else if (format == "tiD") {
+    fixed(ArrowIPCType::INTERVAL, 8);
+    layout.type_table.AddScalar<int16_t>(0, 1);
+  } else if (format == "tin") {
+    fixed(ArrowIPCType::INTERVAL, 16);
+    layout.type_table.AddScalar<int16_t>(0, 2);
+  } else if (format == "+l") {
+    list(ArrowIPCType::LIST, 4);
+  } else if (format == "+L") {
+    list(ArrowIPCType::LARGE_LIST, 8);
+  } else if (format == "+m") {
+    list(ArrowIPCType::MAP, 4);
+    layout.type_table.AddScalar<uint8_t>(0, false);
+  } else if (StringUtil::StartsWith(format, "+w:")) {
+    layout.type = ArrowIPCType::FIXED_SIZE_LIST;
+    layout.type_table.AddScalar<int32_t>(0, std::stoi(format.substr(3)));
+  } else if (format == "+s") {
+    layout.type = ArrowIPCType::STRUCT;
+  } else {
+    throw NotImplementedException("Unsupported Arrow format: %s", format);
+  }
+  return layout;
+}
+
+// Reads the key-value pairs of Arrow C data interface metadata.
+vector<FlatTable> ReadMetadata(const char *metadata) {
+  vector<FlatTable> key_values;
+  if (!metadata) {
+    return key_values;
+  }
+  auto read_int32 = [&]() {
+    int32_t value;
+    memcpy(&value, metadata, sizeof(int32_t));
+    metadata += sizeof(int32_t);
+    return value;
+  };
+  auto read_string = [&]() {
+    auto length = read_int32();
+    std::string value(metadata, length);
+    metadata += length;
+    return value;
+  };
+  auto count = read_int32();
+  for (int32_t i = 0; i < count; i++) {
+    FlatTable key_value;
+    key_value.AddString(0, read_string());
+    key_value.AddString(1, read_string());
+    key_values.push_back(std::move(key_value));
+  }
+  return key_values;
+}
+
+FlatTable MakeField(const ArrowSchema &schema) {
+  if (schema.dictionary) {
+    throw NotImplementedException("Dictionary-encoded Arrow arrays are not "
+                                  "supported");
+  }
+  auto layout = GetArrowLayout(schema.format);
+
+  FlatTable field;
+  field.AddString(0, schema.name ? schema.name : "");
+  field.AddScalar<uint8_t>(1, (schema.flags & ARROW_FLAG_NULLABLE) != 0);
+  field.AddScalar<uint8_t>(2, static_cast<uint8_t>(layout.type));
+  field.AddTable(3, std::move(layout.type_table));
+  vector<FlatTable> children;
+  for (int64_t i = 0; i < schema.n_children; i++) {
+    children.push_back(MakeField(*schema.children[i]));
+  }
+  field.AddTables(5, std::move(children));
+  auto metadata = ReadMetadata(schema.metadata);
+  if (!metadata.empty()) {
+    field.AddTables(6, std::move(metadata));
+  }
+  return field;
+}
+
+struct ArrowBuffer {
+  const void *data;
+  idx_t size;
+};
+
+// Lists the field nodes and buffers of `array` and its children, in the
+// (depth-first) order of a record batch.
+void AddArray(const ArrowSchema &schema, const ArrowArray &array,
+              vector<FlatStruct> &nodes, vector<ArrowBuffer> &buffers) {
+  if (array.offset != 0) {
+    throw NotImplementedException("Arrow arrays with offsets are not "
+                                  "supported");
+  }
+  auto layout = GetArrowLayout(schema.format);
+  auto length = NumericCast<idx_t>(array.length);
+  auto validity = array.n_buffers > 0 ? array.buffers[0] : nullptr;
+
+  auto null_count = array.null_count;
+  if (null_count < 0) {
+    null_count = 0;
+    if (validity) {
+      auto bits = static_cast<const uint8_t *>(validity);
+      for (idx_t i = 0; i < length; i++) {
+        null_count += (bits[i / 8] & (1 << (i % 8))) == 0;
+      }
+    }
+  }
+  nodes.push_back({array.length, null_count});
+
+  if (layout.type == ArrowIPCType::NULL_TYPE) {
+    // Null arrays have no buffers.
+  } else {
+    buffers.push_back({validity, validity ? (length + 7) / 8 : 0});
+    if (layout.type == ArrowIPCType::BOOL) {
+      buffers.push_back({array.buffers[1], (length + 7) / 8});
+    } else if (layout.value_width > 0) {
+      buffers.push_back({array.buffers[1], length * layout.value_width});
+    } else if (layout.offset_width > 0) {
+      auto offsets = array.buffers[1];
+      buffers.push_back({offsets, (length + 1) * layout.offset_width});
+      if (layout.variable_length) {
+        int64_t data_size;
+        if (layout.offset_width == sizeof(int32_t)) {
+          data_size = static_cast<const int32_t *>(offsets)[length];
+        } else {
+          data_size = static_cast<const int64_t *>(offsets)[length];
+        }
+        buffers.push_back({array.buffers[2], NumericCast<idx_t>(data_size)});
+      }
+    }
+  }
+
+  for (int64_t i = 0; i < schema.n_children; i++) {
+    AddArray(*schema.children[i], *array.children[i], nodes, buffers);
+  }
+}
+
+void WriteMessage(uint8_t header_type, FlatTable header, int64_t body_length,
+                  std::string &out) {
+  FlatTable message;
+  message.AddScalar<int16_t>(0, METADATA_VERSION_V5);
+  message.AddScalar<uint8_t>(1, header_type);
+  message.AddTable(2, std::move(header));
+  message.AddScalar<int64_t>(3, body_length);
+  auto metadata = FlatBuffer::Finish(message);
+
+  // Continuation marker, followed by the length of the metadata.
+  uint32_t prefix[2] = {0xFFFFFFFF, static_cast<uint32_t>(metadata.size())};
+  out.append(reinterpret_cast<const char *>(prefix), sizeof(prefix));
+  out += metadata;
+}
+
+// Replaces types that Arrow represents as dictionaries or unions, which would
+// need additional messages.
+LogicalType GetArrowIPCType(const LogicalType &type) {
+  switch (type.id()) {
+  case LogicalTypeId::ENUM:
+  case LogicalTypeId::UNION:
+    return LogicalType::VARCHAR;
+  case LogicalTypeId::LIST:
+    return LogicalType::LIST(GetArrowIPCType(ListType::GetChildType(type)));
+  case LogicalTypeId::ARRAY:
+    return LogicalType::ARRAY(GetArrowIPCType(ArrayType::GetChildType(type)),
+                              ArrayType::GetSize(type));
+  case LogicalTypeId::MAP:
+    return LogicalType::MAP(GetArrowIPCType(MapType::KeyType(type)),
+                            GetArrowIPCType(MapType::ValueType(type)));
+  case LogicalTypeId::STRUCT: {
+    child_list_t<LogicalType> children;
+    for (auto &child : StructType::GetChildTypes(type)) {
+      children.emplace_back(child.first, GetArrowIPCType(child.second));
+    }
+    return LogicalType::STRUCT(std::move(children));
+  }
+  default:
+    return type;
+  }
+}
+
+} // namespace
+
+ArrowIPCWriter::ArrowIPCWriter(
+    shared_ptr<ClientContext> _context,
+    const ColumnNamesAndTypes &column_names_and_types)
+    : context(std::move(_context)), types(column_names_and_types.types),
+      options(context->GetClientProperties()) {
+  for (auto &type : types) {
+    arrow_types.push_back(GetArrowIPCType(type));
+  }
+  // String views would need variadic buffer counts in each record batch.
+  options.produce_arrow_string_view = false;
+  ArrowConverter::ToArrowSchema(&schema.arrow_schema, arrow_types,
+                                column_names_and_types.names, options);
+  extension_types =
+      ArrowTypeExtensionData::GetExtensionTypes(*context, arrow_types);
+}
+
+void ArrowIPCWriter::WriteSchema(std::string &out) {
+  vector<FlatTable> fields;
+  for (int64_t i = 0; i < schema.arrow_schema.n_children; i++) {
+    fields.push_back(MakeField(*schema.arrow_schema.children[i]));
+  }
+  FlatTable schema_table;
+  schema_table.AddScalar<int16_t>(0, 0); // little endian
+  schema_table.AddTables(1, std::move(fields));
+
+  WriteMessage(MESSAGE_HEADER_SCHEMA, std::move(schema_table), 0, out);
+}
+
+void ArrowIPCWriter::WriteRecordBatch(Chunk &chunk, std::string &out) {
+  DataChunk data_chunk;
+  data_chunk.Initialize(Allocator::DefaultAllocator(), arrow_types,
+                        chunk.row_count);
+  for (idx_t i = 0; i < chunk.vectors.size(); i++) {
+    if (types[i] == arrow_types[i]) {
+      data_chunk.data[i].Reference(chunk.vectors[i]);
+    } else {
+      VectorOperations::Cast(*context, chunk.vectors[i], data_chunk.data[i],
+                             chunk.row_count);
+    }
+  }
+  data_chunk.SetCardinality(chunk.row_count);
+
+  ArrowAppender appender(arrow_types, data_chunk.size(), options,
+                         extension_types);
+  appender.Append(data_chunk, 0, data_chunk.size(), data_chunk.size());
+  ArrowArrayWrapper array;
+  array.arrow_array = appender.Finalize();
+
+  vector<FlatStruct> nodes;
+  vector<ArrowBuffer> buffers;
+  for (int64_t i = 0; i < schema.arrow_schema.n_children; i++) {
+    AddArray(*schema.arrow_schema.children[i],
+             *array.arrow_array.children[i], nodes, buffers);
+  }
+
+  // Each buffer in the body is padded to a multiple of 8 bytes.
+  vector<FlatStruct> buffer_positions;
+  idx_t body_length = 0;
+  for (auto &buffer : buffers) {
+    buffer_positions.push_back({NumericCast<int64_t>(body_length),
+                                NumericCast<int64_t>(buffer.size)});
+    body_length += (buffer.size + 7) / 8 * 8;
+  }
+
+  FlatTable record_batch;
+  record_batch.AddScalar<int64_t>(0, data_chunk.size());
+  record_batch.AddReference(1, [nodes](FlatBuffer &buffer) {
+    return buffer.WriteStructs(nodes);
+  });
+  record_batch.AddReference(2, [buffer_positions](FlatBuffer &buffer) {
+    return buffer.WriteStructs(buffer_positions);
+  });
+  WriteMessage(MESSAGE_HEADER_RECORD_BATCH, std::move(record_batch),
+               body_length, out);
+
+  out.reserve(out.size() + body_length);
+  for (auto &buffer : buffers) {
+    if (buffer.size > 0) {
+      out.append(static_cast<const char *>(buffer.data), buffer.size);
+    }
+    out.append((8 - buffer.size % 8) % 8, '\0');
+  }
+}
+
+void ArrowIPCWriter::WriteEndOfStream(std::string &out) {
+  uint32_t end_of_stream[2] = {0xFFFFFFFF, 0};
+  out.append(reinterpret_cast<const char *>(end_of_stream),
+             sizeof(end_of_stream));
+}
+
+} // namespace ui
+} // namespace duckdb
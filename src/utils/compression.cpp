@@ -0,0 +1,187 @@
+#include "utils/compression.hpp"
+
+#include "miniz.hpp"
+#include "zstd.h"
+
+#include <cstring>
+
+namespace duckdb {
+namespace ui {
+
+ContentEncoding NegotiateContentEncoding(const std::string &accept_encoding) {
+  auto accepts_gzip = false;
+  auto accepts_zstd = false;
+  for (auto &coding : StringUtil::Split(accept_encoding, ',')) {
+    auto parts = StringUtil::Split(coding, ';');
+    if (parts.empty()) {
+      continue;
+    }
+    auto name = StringUtil::Lower(parts[0]);
+    StringUtil::Trim(name);
+    auto acceptable = true;
+    for (idx_t i = 1; i < parts.size(); i++) {
+      auto param = StringUtil::Lower(parts[i]);
+      StringUtil::Trim(param);
+      if (StringUtil::StartsWith(param, "q=")) {
+        acceptable = std::strtod(param.c_str() + 2, nullptr) > 0;
+      }
+    }
+    if (name == "gzip") {
+      accepts_gzip = acceptable;
+    } else if (name == "zstd") {
+      accepts_zstd = acceptable;
+    }
+  }
+
+  if (accepts_zstd) {
+    return ContentEncoding::ZSTD;
+  }
+  if (accepts_gzip) {
+    return ContentEncoding::GZIP;
+  }
+  return ContentEncoding::NONE;
+}
+
+const char *ContentEncodingName(ContentEncoding encoding) {
+  switch (encoding) {
+  case ContentEncoding::GZIP:
+    return "gzip";
+  case ContentEncoding::ZSTD:
+    return "zstd";
+  default:
+    return "identity";
+  }
+}
+
+// Favors speed: the responses are produced and consumed interactively.
+constexpr int ZSTD_COMPRESSION_LEVEL = 3;
+constexpr int GZIP_COMPRESSION_LEVEL = 6;
+
+class ZstdResponseCompressor : public ResponseCompressor {
+public:
+  ZstdResponseCompressor() : context(duckdb_zstd::ZSTD_createCCtx()) {
+    if (!context) {
+      throw IOException("Failed to create zstd compression context");
+    }
+    duckdb_zstd::ZSTD_CCtx_setParameter(context,
+                                        duckdb_zstd::ZSTD_c_compressionLevel,
+                                        ZSTD_COMPRESSION_LEVEL);
+  }
+
+  ~ZstdResponseCompressor() override { duckdb_zstd::ZSTD_freeCCtx(context); }
+
+  void Compress(const char *data, idx_t size, bool last,
+                std::string &out) override {
+    duckdb_zstd::ZSTD_inBuffer input = {data, size, 0};
+    auto directive =
+        last ? duckdb_zstd::ZSTD_e_end : duckdb_zstd::ZSTD_e_flush;
+    size_t remaining;
+    do {
+      auto offset = out.size();
+      out.resize(offset + duckdb_zstd::ZSTD_CStreamOutSize());
+      duckdb_zstd::ZSTD_outBuffer output = {&out[offset], out.size() - offset,
+                                            0};
+      remaining = duckdb_zstd::ZSTD_compressStream2(context, &output, &input,
+                                                    directive);
+      out.resize(offset + output.pos);
+      if (duckdb_zstd::ZSTD_isError(remaining)) {
+        throw IOException("zstd compression failed: %s",
+                          duckdb_zstd::ZSTD_getErrorName(remaining));
+      }
+    } while (remaining != 0);
+  }
+
+private:
+  duckdb_zstd::ZSTD_CCtx *context;
+};
+
+// Writes a gzip member: a fixed header, raw deflate data, and a trailer with
+// the CRC32 and size of the uncompressed data.
+class GzipResponseCompressor : public ResponseCompressor {
+public:
+  GzipResponseCompressor() {
+    memset(&stream, 0, sizeof(stream));
+    auto status = duckdb_miniz::mz_deflateInit2(
+        &stream, GZIP_COMPRESSION_LEVEL, MZ_DEFLATED, -MZ_DEFAULT_WINDOW_BITS,
+        1, 0);
+    if (status != duckdb_miniz::MZ_OK) {
+      throw IOException("Failed to initialize gzip compression");
+    }
+  }
+
+  ~GzipResponseCompressor() override { duckdb_miniz::mz_deflateEnd(&stream); }
+
+  void Compress(const char *data, idx_t size, bool last,
+                std::string &out) override {
+    if (!header_written) {
+      // Magic number, deflate method, no flags, no modification time, no
+      // extra flags, unknown OS.
+      static const char GZIP_HEADER[] = {'\x1f', '\x8b', '\x08', '\x00',
+                                         '\x00', '\x00', '\x00', '\x00',
+                                         '\x00', '\xff'};
+      out.append(GZIP_HEADER, sizeof(GZIP_HEADER));
+      header_written = true;
+    }
+
+    if (size > 0) {
+      crc = duckdb_miniz::mz_crc32(
+          crc, reinterpret_cast<const unsigned char *>(data), size);
+      uncompressed_size += size;
+    }
+
+    stream.next_in = reinterpret_cast<const unsigned char *>(data);
+    stream.avail_in = static_cast<unsigned int>(size);
+    auto flush = last ? duckdb_miniz::MZ_FINISH : duckdb_miniz::MZ_SYNC_FLUSH;
+    while (true) {
+      auto offset = out.size();
+      auto capacity = static_cast<unsigned int>(
+          duckdb_miniz::mz_deflateBound(&stream, stream.avail_in) + 64);
+      out.resize(offset + capacity);
+      stream.next_out = reinterpret_cast<unsigned char *>(&out[offset]);
+      stream.avail_out = capacity;
+      auto status = duckdb_miniz::mz_deflate(&stream, flush);
+      out.resize(offset + capacity - stream.avail_out);
+      if (status == duckdb_miniz::MZ_STREAM_END) {
+        break;
+      }
+      if (status != duckdb_miniz::MZ_OK &&
+          status != duckdb_miniz::MZ_BUF_ERROR) {
+        throw IOException("gzip compression failed");
+      }
+      // Done once all input is consumed and the output buffer wasn't filled,
+      // i.e. nothing is left to flush.
+      if (!last && stream.avail_in == 0 && stream.avail_out != 0) {
+        break;
+      }
+    }
+
+    if (last) {
+      for (auto value : {crc, static_cast<uint32_t>(uncompressed_size)}) {
+        for (idx_t i = 0; i < 4; i++) {
+          out += static_cast<char>((value >> (8 * i)) & 0xFF);
+        }
+      }
+    }
+  }
+
+private:
+  duckdb_miniz::mz_stream stream;
+  bool header_written = false;
+  uint32_t crc = 0;
+  idx_t uncompressed_size = 0;
+};
+
+unique_ptr<ResponseCompressor>
+ResponseCompressor::Create(ContentEncoding encoding) {
+  switch (encoding) {
+  case ContentEncoding::GZIP:
+    return make_uniq<GzipResponseCompressor>();
+  case ContentEncoding::ZSTD:
+    return make_uniq<ZstdResponseCompressor>();
+  default:
+    return nullptr;
+  }
+}
+
+} // namespace ui
+} // namespace duckdb
@@ -2,10 +2,20 @@
 
 #include "duckdb/common/serializer/deserializer.hpp"
 #include "duckdb/common/serializer/serializer.hpp"
+#include "duckdb/common/types/vector.hpp"
+
+#include <unordered_map>
 
 namespace duckdb {
 namespace ui {
 
+unique_ptr<RunRequest> RunRequest::Deserialize(Deserializer &deserializer) {
+  auto result = make_uniq<RunRequest>();
+  deserializer.ReadProperty(100, "sql", result->sql);
+  deserializer.ReadPropertyWithDefault(101, "parameters", result->parameters);
+  return result;
+}
+
 void EmptyResult::Serialize(Serializer &) const {}
 
 void TokenizeResult::Serialize(Serializer &serializer) const {
@@ -19,21 +29,146 @@ void ColumnNamesAndTypes::Serialize(Serializer &serializer) const {
   serializer.WriteProperty(101, "types", types);
 }
 
+// Writes the entries of the dictionary used by the rows, followed by the
+// position of the entry of each row. Returns false without writing anything if
+// that wouldn't be smaller than the flattened vector.
+static bool SerializeDictionaryVector(Serializer &serializer, Vector &vector,
+                                      idx_t row_count) {
+  auto &dictionary = DictionaryVector::Child(vector);
+  auto &selection = DictionaryVector::SelVector(vector);
+
+  // The dictionary can be much larger than the chunk (e.g. a Parquet
+  // dictionary page), so only the entries used by the rows are sent.
+  std::unordered_map<idx_t, uint32_t> entry_positions;
+  SelectionVector used_entries(row_count);
+  duckdb::vector<uint32_t> positions(row_count);
+  for (idx_t i = 0; i < row_count; i++) {
+    auto entry = selection.get_index(i);
+    auto it = entry_positions.find(entry);
+    if (it == entry_positions.end()) {
+      auto position = static_cast<uint32_t>(entry_positions.size());
+      used_entries.set_index(position, entry);
+      it = entry_positions.emplace(entry, position).first;
+    }
+    positions[i] = it->second;
+  }
+
+  auto used_count = entry_positions.size();
+  auto physical_type = vector.GetType().InternalType();
+  if (TypeIsConstantSize(physical_type)) {
+    auto width = GetTypeIdSize(physical_type);
+    if (used_count * width + row_count * sizeof(uint32_t) >=
+        row_count * width) {
+      return false;
+    }
+  } else if (used_count >= row_count) {
+    return false;
+  }
+
+  Vector used_dictionary(vector.GetType(), used_count);
+  VectorOperations::Copy(dictionary, used_dictionary, used_entries, used_count,
+                         0, 0);
+  serializer.WriteProperty(90, "vector_type",
+                           static_cast<uint8_t>(VectorType::DICTIONARY_VECTOR));
+  serializer.WriteProperty(91, "selection",
+                           reinterpret_cast<const_data_ptr_t>(positions.data()),
+                           row_count * sizeof(uint32_t));
+  used_dictionary.Serialize(serializer, used_count);
+  return true;
+}
+
+// Writes the vector into the current object. Compressed vectors start with
+// their vector type (field 90), followed by:
+//  - CONSTANT_VECTOR: the value, as a vector of one row.
+//  - DICTIONARY_VECTOR: the position of the entry of each row (field 91, as
+//    uint32), then the entries, as a vector.
+//  - SEQUENCE_VECTOR: the start and increment (field 92, as two int64).
+// Other vectors, and vectors that wouldn't get smaller, are flattened and
+// written as in version 1.
+static void SerializeVector(Serializer &serializer, const Vector &source,
+                            idx_t row_count, bool compress) {
+  // Reference the vector to avoid potentially mutating it during serialization
+  Vector vector(source.GetType());
+  vector.Reference(source);
+
+  if (compress && row_count > 1) {
+    switch (vector.GetVectorType()) {
+    case VectorType::CONSTANT_VECTOR:
+      serializer.WriteProperty(
+          90, "vector_type", static_cast<uint8_t>(VectorType::CONSTANT_VECTOR));
+      vector.Flatten(1);
+      vector.Serialize(serializer, 1);
+      return;
+    case VectorType::DICTIONARY_VECTOR:
+      if (SerializeDictionaryVector(serializer, vector, row_count)) {
+        return;
+      }
+      break;
+    case VectorType::SEQUENCE_VECTOR:
+      switch (vector.GetType().id()) {
+      case LogicalTypeId::TINYINT:
+      case LogicalTypeId::SMALLINT:
+      case LogicalTypeId::INTEGER:
+      case LogicalTypeId::BIGINT: {
+        int64_t sequence[2];
+        SequenceVector::GetSequence(vector, sequence[0], sequence[1]);
+        serializer.WriteProperty(
+            90, "vector_type",
+            static_cast<uint8_t>(VectorType::SEQUENCE_VECTOR));
+        serializer.WriteProperty(
+            92, "sequence", reinterpret_cast<const_data_ptr_t>(sequence),
+            sizeof(sequence));
+        return;
+      }
+      default:
+        break;
+      }
+      break;
+    default:
+      break;
+    }
+  }
+
+  // Results are fetched without flattening them, so flatten them here.
+  vector.Flatten(row_count);
+  vector.Serialize(serializer, row_count);
+}
+
+idx_t Chunk::GetAllocationSize() const {
+  idx_t size = 0;
+  for (auto &vector : vectors) {
+    size += vector.GetAllocationSize(row_count);
+  }
+  return size;
+}
+
 // Adapted from parts of DataChunk::Serialize
 void Chunk::Serialize(Serializer &serializer) const {
   serializer.WriteProperty(100, "row_count", row_count);
   serializer.WriteList(101, "vectors", vectors.size(),
                        [&](Serializer::List &list, idx_t i) {
                          list.WriteObject([&](Serializer &object) {
-                           // Reference the vector to avoid potentially mutating
-                           // it during serialization
-                           Vector serialized_vector(vectors[i].GetType());
-                           serialized_vector.Reference(vectors[i]);
-                           serialized_vector.Serialize(object, row_count);
+                           SerializeVector(object, vectors[i], row_count,
+                                           compress_vectors);
                          });
                        });
 }
 
+void ColumnProfile::Serialize(Serializer &serializer) const {
+  serializer.WriteProperty(100, "null_count", null_count);
+  serializer.WriteProperty(101, "distinct_count_estimate",
+                           distinct_count_estimate);
+  if (has_min_max) {
+    serializer.WriteProperty(102, "min", min);
+    serializer.WriteProperty(103, "max", max);
+  }
+  if (!histogram_counts.empty()) {
+    serializer.WriteProperty(104, "histogram_min", histogram_min);
+    serializer.WriteProperty(105, "histogram_max", histogram_max);
+    serializer.WriteProperty(106, "histogram_counts", histogram_counts);
+  }
+}
+
 void SuccessResult::Serialize(Serializer &serializer) const {
   serializer.WriteProperty(100, "success", true);
   serializer.WriteProperty(101, "column_names_and_types",
@@ -41,6 +176,47 @@ void SuccessResult::Serialize(Serializer &serializer) const {
   serializer.WriteList(
       102, "chunks", chunks.size(),
       [&](Serializer::List &list, idx_t i) { list.WriteElement(chunks[i]); });
+  serializer.WritePropertyWithDefault(103, "cursor_id", cursor_id);
+  if (!column_profiles.empty()) {
+    serializer.WriteList(104, "column_profiles", column_profiles.size(),
+                         [&](Serializer::List &list, idx_t i) {
+                           list.WriteElement(column_profiles[i]);
+                         });
+  }
+}
+
+void StreamHeader::Serialize(Serializer &serializer) const {
+  serializer.WriteProperty(100, "success", true);
+  serializer.WriteProperty(101, "column_names_and_types",
+                           column_names_and_types);
+}
+
+void StreamFrame::Serialize(Serializer &serializer) const {
+  serializer.WriteProperty(100, "done", done);
+  if (done) {
+    serializer.WriteProperty(101, "error", error);
+  } else {
+    serializer.WriteProperty(102, "chunk", chunk);
+  }
+}
+
+void ScriptStatementResult::Serialize(Serializer &serializer) const {
+  serializer.WriteProperty(100, "statement_type", statement_type);
+  serializer.WriteProperty(101, "elapsed_microseconds", elapsed_microseconds);
+  serializer.WriteProperty(102, "changed_rows", changed_rows);
+  serializer.WriteProperty(103, "row_count", row_count);
+  serializer.WritePropertyWithDefault(104, "error", error);
+}
+
+// Laid out like ErrorResult when a statement failed, so clients unaware of
+// scripts still see the error.
+void ScriptResult::Serialize(Serializer &serializer) const {
+  serializer.WriteProperty(100, "success", error.empty());
+  serializer.WritePropertyWithDefault(101, "error", error);
+  serializer.WriteList(102, "statements", statements.size(),
+                       [&](Serializer::List &list, idx_t i) {
+                         list.WriteElement(statements[i]);
+                       });
 }
 
 void ErrorResult::Serialize(Serializer &serializer) const {
@@ -6,6 +6,7 @@
 #include "utils/md_helpers.hpp"
 #include "http_server.hpp"
 #include "settings.hpp"
+#include "state.hpp"
 
 namespace duckdb {
 namespace ui {
@@ -13,16 +14,12 @@ namespace ui {
 Watcher::Watcher(HttpServer &_server)
     : should_run(false), server(_server), watched_database(nullptr) {}
 
-bool WasCatalogUpdated(DatabaseInstance &db, Connection &connection,
-                       CatalogState &last_state) {
-  bool has_change = false;
+CatalogState GetCatalogState(DatabaseInstance &db, Connection &connection) {
+  CatalogState state;
   auto &context = *connection.context;
   connection.BeginTransaction();
 
   const auto &databases = db.GetDatabaseManager().GetDatabases(context);
-  std::set<idx_t> db_oids;
-
-  // Check currently attached databases
   for (const auto &db_ref : databases) {
 #if DUCKDB_VERSION_AT_MOST(1, 3, 2)
 	auto &db_instance = db_ref.get();
@@ -33,30 +30,26 @@ bool WasCatalogUpdated(DatabaseInstance &db, Connection &connection,
       continue; // ignore temp databases
     }
 
-    db_oids.insert(db_instance.oid);
     auto &catalog = db_instance.GetCatalog();
-    auto current_version = catalog.GetCatalogVersion(context);
-    auto last_version_it = last_state.db_to_catalog_version.find(db_instance.oid);
-    if (last_version_it == last_state.db_to_catalog_version.end() // first time
-        || !(last_version_it->second == current_version)) {       // updated
-      has_change = true;
-      last_state.db_to_catalog_version[db_instance.oid] = current_version;
-    }
+    state.db_to_catalog_version[db_instance.oid] =
+        catalog.GetCatalogVersion(context);
   }
 
-  // Now check if any databases have been detached
-  for (auto it = last_state.db_to_catalog_version.begin();
-       it != last_state.db_to_catalog_version.end();) {
-    if (db_oids.find(it->first) == db_oids.end()) {
-      has_change = true;
-      it = last_state.db_to_catalog_version.erase(it);
-    } else {
-      ++it;
-    }
+  connection.Rollback();
+  return state;
+}
+
+// A change is either a new catalog version of an attached database, or a
+// database being attached or detached.
+bool WasCatalogUpdated(DatabaseInstance &db, Connection &connection,
+                       CatalogState &last_state) {
+  auto current_state = GetCatalogState(db, connection);
+  if (current_state == last_state) {
+    return false;
   }
 
-  connection.Rollback();
-  return has_change;
+  last_state = std::move(current_state);
+  return true;
 }
 
 void Watcher::Watch() {
@@ -85,6 +78,8 @@ void Watcher::Watch() {
         server.event_dispatcher->SendCatalogChangedEvent();
       }
 
+      UIStorageExtensionInfo::GetState(*db).EvictIdleCursors();
+
       if (!is_md_connected && IsMDConnected(con)) {
         is_md_connected = true;
         server.event_dispatcher->SendConnectedEvent(GetMDToken(con));
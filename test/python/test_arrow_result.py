@@ -0,0 +1,136 @@
+import datetime
+import decimal
+import struct
+import unittest
+
+from ui_server import QueryError, UIServer
+
+try:
+    import pyarrow as pa
+except ImportError:
+    pa = None
+
+# Enough rows for several record batches.
+ROW_COUNT = 100000
+
+QUERY = """
+SELECT
+  i,
+  i::VARCHAR AS s,
+  CASE WHEN i %% 3 = 0 THEN NULL ELSE i / 2 END AS d,
+  i %% 2 = 0 AS b,
+  DATE '2024-01-01' + i::INTEGER AS dt,
+  (i %% 7)::DECIMAL(10, 2) AS dec,
+  CASE WHEN i %% 5 = 0 THEN NULL ELSE [i, i + 1] END AS l,
+  {'a': i, 'b': 'x'} AS st,
+  42 AS c
+FROM range(%d) t(i)
+"""
+
+ARROW = {"X-DuckDB-UI-Result-Format": "arrow"}
+
+END_OF_STREAM = b"\xff\xff\xff\xff\x00\x00\x00\x00"
+
+
+def expected_row(i):
+    return {
+        "i": i,
+        "s": str(i),
+        "d": None if i % 3 == 0 else i / 2,
+        "b": i % 2 == 0,
+        "dt": datetime.date(2024, 1, 1) + datetime.timedelta(days=i),
+        "dec": decimal.Decimal(i % 7),
+        "l": None if i % 5 == 0 else [i, i + 1],
+        "st": {"a": i, "b": "x"},
+        "c": 42,
+    }
+
+
+def message_lengths(body):
+    """Returns the metadata and body lengths of the messages of an Arrow IPC
+    stream, checking their framing along the way."""
+    lengths = []
+    offset = 0
+    while True:
+        continuation, metadata_length = struct.unpack_from("<Ii", body, offset)
+        if continuation != 0xFFFFFFFF:
+            raise AssertionError("No continuation marker at offset %d" % offset)
+        offset += 8
+        if metadata_length == 0:
+            if offset != len(body):
+                raise AssertionError("Bytes after the end of the stream")
+            return lengths
+        if metadata_length % 8 != 0:
+            raise AssertionError("Unaligned metadata at offset %d" % offset)
+        # The body length is in the Message table, which pyarrow reads for us.
+        message = pa.ipc.read_message(pa.py_buffer(body[offset - 8:]))
+        lengths.append((metadata_length, message.body.size))
+        if message.body.size % 8 != 0:
+            raise AssertionError("Unaligned body at offset %d" % offset)
+        offset += metadata_length + message.body.size
+
+
+@unittest.skipIf(pa is None, "requires pyarrow")
+class ArrowResultTest(unittest.TestCase):
+    @classmethod
+    def setUpClass(cls):
+        cls.server = UIServer()
+
+    @classmethod
+    def tearDownClass(cls):
+        cls.server.close()
+
+    def check(self, response):
+        self.assertEqual(response.status, 200)
+        self.assertEqual(
+            response.headers["Content-Type"], "application/vnd.apache.arrow.stream"
+        )
+        self.assertTrue(response.body.endswith(END_OF_STREAM))
+        reader = pa.ipc.open_stream(response.body)
+        batches = list(reader)
+        self.assertGreater(len(batches), 1)
+        # The schema, then one message per record batch.
+        self.assertEqual(len(message_lengths(response.body)), 1 + len(batches))
+        table = pa.Table.from_batches(batches, schema=reader.schema)
+        self.assertEqual(
+            table.schema.names, ["i", "s", "d", "b", "dt", "dec", "l", "st", "c"]
+        )
+        types = [field.type for field in table.schema]
+        self.assertTrue(pa.types.is_int64(types[0]))
+        self.assertTrue(
+            pa.types.is_string(types[1]) or pa.types.is_large_string(types[1])
+        )
+        self.assertTrue(pa.types.is_float64(types[2]))
+        self.assertTrue(pa.types.is_boolean(types[3]))
+        self.assertTrue(pa.types.is_date32(types[4]))
+        self.assertTrue(pa.types.is_decimal(types[5]))
+        self.assertTrue(pa.types.is_list(types[6]) or pa.types.is_large_list(types[6]))
+        self.assertTrue(pa.types.is_struct(types[7]))
+        self.assertTrue(pa.types.is_int32(types[8]))
+        self.assertEqual(table.column("d").null_count, (ROW_COUNT + 2) // 3)
+        self.assertEqual(table.column("l").null_count, ROW_COUNT // 5)
+        self.assertEqual(table.to_pylist(), [expected_row(i) for i in range(ROW_COUNT)])
+
+    def test_buffered(self):
+        self.check(self.server.run(QUERY % ROW_COUNT, ARROW))
+
+    def test_streamed(self):
+        headers = dict(ARROW, **{"X-DuckDB-UI-Stream-Result": "true"})
+        self.check(self.server.run(QUERY % ROW_COUNT, headers))
+
+    def test_empty_result(self):
+        response = self.server.run("SELECT 1 AS i WHERE false", ARROW)
+        self.assertEqual(len(message_lengths(response.body)), 1)
+        table = pa.ipc.open_stream(response.body).read_all()
+        self.assertEqual(table.schema.names, ["i"])
+        self.assertEqual(table.num_rows, 0)
+
+    def test_errors_are_error_results(self):
+        response = self.server.run("SELECT * FROM missing_table", ARROW)
+        self.assertEqual(response.headers["Content-Type"], "application/octet-stream")
+        with self.assertRaisesRegex(QueryError, "missing_table"):
+            response.result()
+
+
+if __name__ == "__main__":
+    unittest.main()
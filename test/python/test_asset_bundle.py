@@ -0,0 +1,105 @@
+import io
+import os
+import tarfile
+import unittest
+
+from ui_server import QueryError, RemoteUI, UIServer
+
+ASSETS = {
+    "index.html": b"<html><script src=\"/assets/app.js\"></script></html>",
+    "assets/app.js": b"console.log('bundled');",
+    "VERSION": b"1.2.3",
+}
+
+
+def write_bundle(path, assets):
+    with tarfile.open(path, "w", format=tarfile.USTAR_FORMAT) as tar:
+        for name, data in assets.items():
+            info = tarfile.TarInfo(name)
+            info.size = len(data)
+            tar.addfile(info, io.BytesIO(data))
+
+
+class AssetBundleTest(unittest.TestCase):
+    def setUp(self):
+        self.remote = RemoteUI()
+        self.remote.put("/", b"remote")
+        self.server = UIServer(remote=self.remote)
+        self.bundle_path = os.path.join(self.server.home, "bundle-source.tar")
+        write_bundle(self.bundle_path, ASSETS)
+
+    def tearDown(self):
+        self.server.close()
+        self.remote.close()
+
+    def load_bundle(self, path=None):
+        argument = "'%s'" % path if path else ""
+        return self.server.query(
+            "SELECT version, asset_count FROM ui_load_bundle(%s)" % argument
+        )
+
+    def test_serves_the_bundle(self):
+        self.assertEqual(self.server.get("/").body, b"remote")
+        self.assertEqual(self.load_bundle(self.bundle_path), [("1.2.3", 3)])
+
+        response = self.server.get("/")
+        self.assertEqual(response.status, 200)
+        self.assertEqual(response.body, ASSETS["index.html"])
+        self.assertEqual(response.headers["Content-Type"], "text/html")
+        self.assertEqual(response.headers["Cache-Control"], "no-cache")
+
+        response = self.server.get("/assets/app.js")
+        self.assertEqual(response.body, ASSETS["assets/app.js"])
+        self.assertIn("immutable", response.headers["Cache-Control"])
+        etag = response.headers["ETag"]
+        response = self.server.get("/assets/app.js", {"If-None-Match": etag})
+        self.assertEqual(response.status, 304)
+
+        self.assertEqual(self.server.get("/missing.js").status, 404)
+        # The remote URL isn't asked for anything while serving the bundle.
+        self.assertEqual(len(self.remote.get_requests("/")), 1)
+        self.assertEqual(self.remote.get_requests("/missing.js"), [])
+
+    def test_bundle_is_kept_across_restarts(self):
+        self.load_bundle(self.bundle_path)
+        os.remove(self.bundle_path)
+        self.server.stop()
+        self.server.start()
+        self.assertEqual(self.server.get("/").body, ASSETS["index.html"])
+        self.assertEqual(self.load_bundle(), [("1.2.3", 3)])
+
+    def test_invalid_bundle_keeps_the_installed_one(self):
+        self.load_bundle(self.bundle_path)
+        invalid_path = os.path.join(self.server.home, "invalid.tar")
+        with open(invalid_path, "wb") as f:
+            f.write(b"not a bundle" * 100)
+        with self.assertRaisesRegex(QueryError, "not a tar archive"):
+            self.load_bundle(invalid_path)
+        self.assertEqual(self.server.get("/").body, ASSETS["index.html"])
+
+    def test_new_bundle_replaces_the_installed_one(self):
+        self.load_bundle(self.bundle_path)
+        etag = self.server.get("/").headers["ETag"]
+        write_bundle(self.bundle_path, dict(ASSETS, **{"VERSION": b"1.2.4"}))
+        self.assertEqual(self.load_bundle(self.bundle_path), [("1.2.4", 3)])
+        response = self.server.get("/", {"If-None-Match": etag})
+        self.assertEqual(response.status, 200)
+        self.assertNotEqual(response.headers["ETag"], etag)
+        directory = os.path.join(self.server.home, ".duckdb", "extension_data", "ui")
+        bundles = [name for name in os.listdir(directory) if name.endswith(".tar")]
+        self.assertEqual(len(bundles), 1)
+
+    def test_unload_goes_back_to_the_remote_ui(self):
+        self.load_bundle(self.bundle_path)
+        self.assertEqual(self.server.query("SELECT * FROM ui_unload_bundle()"), [(1,)])
+        self.assertEqual(self.server.get("/").body, b"remote")
+        self.server.stop()
+        self.server.start()
+        self.assertEqual(self.server.get("/").body, b"remote")
+        with self.assertRaisesRegex(QueryError, "No asset bundle installed"):
+            self.load_bundle()
+        self.assertEqual(self.server.query("SELECT * FROM ui_unload_bundle()"), [(0,)])
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,73 @@
+import glob
+import os
+import unittest
+
+from ui_server import RemoteUI, UIServer
+
+SCRIPT = b"console.log('cached');"
+
+
+class AssetCacheTest(unittest.TestCase):
+    def setUp(self):
+        self.remote = RemoteUI()
+        self.server = UIServer(remote=self.remote)
+
+    def tearDown(self):
+        self.server.close()
+        self.remote.close()
+
+    def cached_files(self):
+        directory = os.path.join(
+            self.server.home, ".duckdb", "extension_data", "ui", "assets"
+        )
+        return glob.glob(os.path.join(directory, "*.asset"))
+
+    def test_revalidated_and_served_offline(self):
+        headers = {"ETag": '"v1"', "Cache-Control": "no-cache"}
+        self.remote.put("/app.js", SCRIPT, headers)
+
+        response = self.server.get("/app.js")
+        self.assertEqual(response.status, 200)
+        self.assertEqual(response.body, SCRIPT)
+        self.assertEqual(len(self.cached_files()), 1)
+
+        # Revalidated with the remote URL, which answers it is unchanged.
+        response = self.server.get("/app.js")
+        self.assertEqual(response.status, 200)
+        self.assertEqual(response.body, SCRIPT)
+        request_headers = self.remote.get_requests("/app.js")[-1]
+        self.assertEqual(request_headers["If-None-Match"], '"v1"')
+
+        # Kept across restarts, and served while the remote URL fails.
+        self.server.stop()
+        self.remote.put("/app.js", b"Unavailable", status=503)
+        self.server.start()
+        response = self.server.get("/app.js")
+        self.assertEqual(response.status, 200)
+        self.assertEqual(response.body, SCRIPT)
+        self.assertEqual(response.headers["ETag"], '"v1"')
+
+    def test_changed_asset_replaces_cached_one(self):
+        self.remote.put("/app.css", b"a {}", {"ETag": '"v1"'})
+        self.assertEqual(self.server.get("/app.css").body, b"a {}")
+        self.remote.put("/app.css", b"b {}", {"ETag": '"v2"'})
+        self.assertEqual(self.server.get("/app.css").body, b"b {}")
+        self.remote.put("/app.css", b"Unavailable", status=503)
+        self.assertEqual(self.server.get("/app.css").body, b"b {}")
+
+    def test_uncacheable_assets(self):
+        self.remote.put("/private.js", SCRIPT, {"Cache-Control": "private"})
+        self.remote.put("/cookie.js", SCRIPT, {"Set-Cookie": "session=1"})
+        for path in ("/private.js", "/cookie.js"):
+            self.assertEqual(self.server.get(path).body, SCRIPT)
+        self.assertEqual(self.cached_files(), [])
+        self.remote.put("/private.js", b"Unavailable", status=503)
+        self.assertEqual(self.server.get("/private.js").status, 503)
+
+    def test_missing_assets_are_not_cached(self):
+        self.assertEqual(self.server.get("/missing.js").status, 404)
+        self.assertEqual(self.cached_files(), [])
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,67 @@
+import gzip
+import unittest
+
+from ui_server import RemoteUI, UIServer
+
+IMMUTABLE = {
+    "Cache-Control": "public, max-age=31536000, immutable",
+    "Content-Type": "text/javascript",
+}
+# Large enough to be kept compressed too.
+SCRIPT = b"console.log('kept in memory');\n" * 100
+
+
+class AssetMemoryCacheTest(unittest.TestCase):
+    def setUp(self):
+        self.remote = RemoteUI()
+        self.server = UIServer(remote=self.remote)
+
+    def tearDown(self):
+        self.server.close()
+        self.remote.close()
+
+    def stats(self):
+        (hits, entry_count), = self.server.query(
+            "SELECT hits, entry_count FROM ui_asset_memory_cache_stats()"
+        )
+        return hits, entry_count
+
+    def test_immutable_assets_are_fetched_once(self):
+        self.remote.put("/assets/app.js", SCRIPT, IMMUTABLE)
+        hits, entry_count = self.stats()
+        for _ in range(3):
+            response = self.server.get("/assets/app.js")
+            self.assertEqual(response.status, 200)
+            self.assertEqual(response.body, SCRIPT)
+        self.assertEqual(len(self.remote.get_requests("/assets/app.js")), 1)
+        self.assertEqual(self.stats(), (hits + 2, entry_count + 1))
+
+    def test_compressed_variant(self):
+        self.remote.put("/assets/app.js", SCRIPT, IMMUTABLE)
+        self.server.get("/assets/app.js")
+        response = self.server.get("/assets/app.js", {"Accept-Encoding": "gzip"})
+        self.assertEqual(response.headers["Content-Encoding"], "gzip")
+        self.assertLess(len(response.body), len(SCRIPT))
+        self.assertEqual(gzip.decompress(response.body), SCRIPT)
+        self.assertEqual(len(self.remote.get_requests("/assets/app.js")), 1)
+
+    def test_other_assets_are_revalidated(self):
+        self.remote.put("/index.html", b"<html></html>", {"Cache-Control": "no-cache"})
+        for _ in range(2):
+            self.assertEqual(self.server.get("/index.html").body, b"<html></html>")
+        self.assertEqual(len(self.remote.get_requests("/index.html")), 2)
+
+    def test_disabled(self):
+        self.server.close()
+        self.server = UIServer(
+            settings=["SET ui_asset_memory_cache_size = 0"], remote=self.remote
+        )
+        self.remote.put("/assets/app.js", SCRIPT, IMMUTABLE)
+        for _ in range(2):
+            self.assertEqual(self.server.get("/assets/app.js").body, SCRIPT)
+        self.assertEqual(len(self.remote.get_requests("/assets/app.js")), 2)
+        self.assertEqual(self.stats(), (0, 0))
+
+
+if __name__ == "__main__":
+    unittest.main()
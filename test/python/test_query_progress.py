@@ -0,0 +1,65 @@
+import threading
+import unittest
+
+from ui_server import EventStream, QueryError, UIServer
+
+
+class QueryProgressTest(unittest.TestCase):
+    @classmethod
+    def setUpClass(cls):
+        # The interval is read by the connections of the UI, so it's global.
+        cls.server = UIServer(settings=["SET GLOBAL ui_query_progress_interval = 100"])
+        cls.server.query("CREATE TABLE items AS SELECT i FROM range(1000000) t(i)")
+
+    @classmethod
+    def tearDownClass(cls):
+        cls.server.close()
+
+    def test_progress_of_a_long_query(self):
+        events = EventStream(self.server)
+        try:
+            responses = []
+            # Runs until interrupted.
+            run = threading.Thread(
+                target=lambda: responses.append(
+                    self.server.run(
+                        "SELECT count(*) FROM items a, items b WHERE a.i + b.i < 0",
+                        connection="progress",
+                    )
+                )
+            )
+            run.start()
+            progress = events.wait_for(
+                "QueryProgressEvent",
+                lambda data: data["connectionName"] == "progress"
+                and data["rowsProcessed"] > 0,
+            )
+            self.assertIn("totalRowsToProcess", progress)
+            if "percentComplete" in progress:
+                self.assertGreaterEqual(progress["percentComplete"], 0)
+                self.assertLessEqual(progress["percentComplete"], 100)
+
+            self.server.interrupt("progress")
+            run.join()
+            with self.assertRaisesRegex(QueryError, "nterrupt"):
+                responses[0].result()
+        finally:
+            events.close()
+
+    def test_no_progress_of_quick_queries(self):
+        events = EventStream(self.server)
+        try:
+            rows = self.server.query("SELECT 42", connection="quick")
+            self.assertEqual(rows, [(42,)])
+            with self.assertRaises(AssertionError):
+                events.wait_for(
+                    "QueryProgressEvent",
+                    lambda data: data["connectionName"] == "quick",
+                    timeout=0.5,
+                )
+        finally:
+            events.close()
+
+
+if __name__ == "__main__":
+    unittest.main()
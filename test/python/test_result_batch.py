@@ -0,0 +1,75 @@
+import unittest
+
+from ui_server import QueryError, UIServer
+
+SQL = "SELECT i, i::VARCHAR AS s, 42 AS c FROM range(25000) t(i)"
+ROWS = [(i, str(i), 42) for i in range(25000)]
+
+
+def version(serialization_version, **headers):
+    headers["X-DuckDB-UI-Serialization-Version"] = str(serialization_version)
+    return headers
+
+
+class ResultBatchTest(unittest.TestCase):
+    @classmethod
+    def setUpClass(cls):
+        cls.server = UIServer()
+
+    @classmethod
+    def tearDownClass(cls):
+        cls.server.close()
+
+    def row_counts(self, result):
+        return [row_count for row_count, _ in result.chunks]
+
+    def test_batches_of_the_requested_size(self):
+        headers = version(3)
+        headers["X-DuckDB-UI-Result-Batch-Size"] = "10000"
+        result = self.server.run(SQL, headers).result()
+        self.assertEqual(result.rows(), ROWS)
+        row_counts = self.row_counts(result)
+        self.assertLess(len(row_counts), 25000 // 2048)
+        self.assertIn(10000, row_counts)
+        self.assertTrue(all(row_count <= 10000 for row_count in row_counts))
+
+    def test_batches_of_the_setting_size(self):
+        # The default setting holds the whole result in a batch.
+        result = self.server.run(SQL, version(3)).result()
+        self.assertEqual(result.rows(), ROWS)
+        self.assertEqual(self.row_counts(result), [25000])
+
+    def test_older_clients_get_vector_sized_chunks(self):
+        for serialization_version in (1, 2):
+            headers = version(serialization_version)
+            headers["X-DuckDB-UI-Result-Batch-Size"] = "10000"
+            result = self.server.run(SQL, headers).result()
+            self.assertEqual(result.rows(), ROWS)
+            self.assertTrue(all(count <= 2048 for count in self.row_counts(result)))
+
+    def test_streamed_batches(self):
+        headers = version(3)
+        headers["X-DuckDB-UI-Result-Batch-Size"] = "10000"
+        headers["X-DuckDB-UI-Stream-Result"] = "true"
+        result, error = self.server.run(SQL, headers).stream()
+        self.assertEqual(error, "")
+        self.assertEqual(result.rows(), ROWS)
+        self.assertTrue(all(count <= 10000 for count in self.row_counts(result)))
+
+    def test_invalid_batch_size(self):
+        headers = version(3)
+        headers["X-DuckDB-UI-Result-Batch-Size"] = "many"
+        response = self.server.run(SQL, headers)
+        self.assertEqual(response.status, 400)
+        with self.assertRaisesRegex(QueryError, "Batch-Size"):
+            response.result()
+
+    def test_batch_size_is_bounded(self):
+        headers = version(3)
+        headers["X-DuckDB-UI-Result-Batch-Size"] = "99999999999999999999"
+        result = self.server.run(SQL, headers).result()
+        self.assertEqual(result.rows(), ROWS)
+
+
+if __name__ == "__main__":
+    unittest.main()
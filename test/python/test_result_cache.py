@@ -0,0 +1,83 @@
+import unittest
+
+from ui_server import UIServer, wait_until
+
+CACHE = {"X-DuckDB-UI-Result-Cache": "true"}
+
+
+class ResultCacheTest(unittest.TestCase):
+    @classmethod
+    def setUpClass(cls):
+        cls.server = UIServer()
+
+    @classmethod
+    def tearDownClass(cls):
+        cls.server.close()
+
+    def stats(self):
+        (hits, misses), = self.server.query(
+            "SELECT hits, misses FROM ui_result_cache_stats()"
+        )
+        return hits, misses
+
+    def test_hit_and_invalidation(self):
+        self.server.query("CREATE TABLE items AS SELECT i FROM range(10) t(i)")
+        sql = "SELECT count(*) FROM items"
+        hits, misses = self.stats()
+        first = self.server.run(sql, CACHE, "cached")
+        self.assertEqual(first.result().rows(), [(10,)])
+        self.assertEqual(self.stats(), (hits, misses + 1))
+
+        second = self.server.run(sql, CACHE, "cached")
+        self.assertEqual(second.body, first.body)
+        self.assertEqual(self.stats(), (hits + 1, misses + 1))
+
+        # Statements other than SELECT clear the cache.
+        self.server.query("INSERT INTO items VALUES (10)", connection="writer")
+        self.assertEqual(self.server.query(sql, CACHE, "cached"), [(11,)])
+        self.assertEqual(self.stats(), (hits + 1, misses + 2))
+
+    def test_uncached_without_header(self):
+        sql = "SELECT 42"
+        hits, misses = self.stats()
+        self.server.query(sql, connection="uncached")
+        self.server.query(sql, connection="uncached")
+        self.assertEqual(self.stats(), (hits, misses))
+
+    def test_writes_of_other_connections(self):
+        self.server.query("CREATE TABLE others AS SELECT i FROM range(10) t(i)")
+        sql = "SELECT count(*) FROM others"
+        self.assertEqual(self.server.query(sql, CACHE, "cached"), [(10,)])
+        hits, misses = self.stats()
+
+        # Written by the CLI: the data state of the database changes, and the
+        # cached result is not used.
+        self.server.execute("INSERT INTO others VALUES (10)")
+        wait_until(
+            lambda: self.server.query(sql, connection="check") == [(11,)],
+            "the row is inserted",
+        )
+        self.assertEqual(self.server.query(sql, CACHE, "cached"), [(11,)])
+        self.assertEqual(self.stats(), (hits, misses + 1))
+
+    def test_volatile_results_are_not_cached(self):
+        sql = "SELECT random() AS r"
+        hits, _ = self.stats()
+        first = self.server.query(sql, CACHE, "volatile")
+        second = self.server.query(sql, CACHE, "volatile")
+        self.assertNotEqual(first, second)
+        self.assertEqual(self.stats()[0], hits)
+
+    def test_connections_do_not_share_results(self):
+        self.server.query("CREATE TABLE shared AS SELECT 1 AS i")
+        sql = "SELECT count(*) FROM shared"
+        self.server.query(sql, CACHE, "first")
+        hits, _ = self.stats()
+        self.server.query(sql, CACHE, "second")
+        self.assertEqual(self.stats()[0], hits)
+        self.server.query(sql, CACHE, "first")
+        self.assertEqual(self.stats()[0], hits + 1)
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,68 @@
+import time
+import unittest
+
+from ui_server import QueryError, UIServer
+
+CURSOR = {"X-DuckDB-UI-Result-Cursor": "true", "X-DuckDB-UI-Result-Row-Limit": "3000"}
+
+
+class ResultCursorTest(unittest.TestCase):
+    @classmethod
+    def setUpClass(cls):
+        # The timeout is read by the connections of the UI, so it's global.
+        cls.server = UIServer(settings=["SET GLOBAL ui_cursor_idle_timeout = 1000"])
+
+    @classmethod
+    def tearDownClass(cls):
+        cls.server.close()
+
+    def fetch(self, connection, cursor_id, row_limit=3000):
+        return self.server.request(
+            "/ddb/fetch",
+            headers={
+                "X-DuckDB-UI-Connection-Name": connection,
+                "X-DuckDB-UI-Cursor-Id": cursor_id,
+                "X-DuckDB-UI-Result-Row-Limit": str(row_limit),
+            },
+        ).result()
+
+    def test_pages(self):
+        sql = "SELECT i FROM range(10000) t(i)"
+        result = self.server.run(sql, CURSOR, "paging").result()
+        self.assertTrue(result.cursor_id)
+        rows = result.rows()
+        self.assertEqual(len(rows), 3000)
+        while result.cursor_id:
+            result = self.fetch("paging", result.cursor_id)
+            self.assertLessEqual(len(result.rows()), 3000)
+            rows.extend(result.rows())
+        self.assertEqual(rows, [(i,) for i in range(10000)])
+
+    def test_no_cursor_for_a_complete_result(self):
+        result = self.server.run("SELECT 42", CURSOR, "complete").result()
+        self.assertEqual(result.cursor_id, "")
+        self.assertEqual(result.rows(), [(42,)])
+
+    def test_idle_cursor_expires(self):
+        sql = "SELECT i FROM range(10000) t(i)"
+        result = self.server.run(sql, CURSOR, "idle").result()
+        self.assertTrue(result.cursor_id)
+        time.sleep(2)
+        with self.assertRaisesRegex(QueryError, "not found or expired"):
+            self.fetch("idle", result.cursor_id)
+
+    def test_run_closes_the_cursor(self):
+        sql = "SELECT i FROM range(10000) t(i)"
+        result = self.server.run(sql, CURSOR, "replaced").result()
+        self.assertTrue(result.cursor_id)
+        self.server.query("SELECT 1", connection="replaced")
+        with self.assertRaisesRegex(QueryError, "not found or expired"):
+            self.fetch("replaced", result.cursor_id)
+
+    def test_cursor_requires_a_connection(self):
+        with self.assertRaisesRegex(QueryError, "connection name"):
+            self.server.run("SELECT 1", CURSOR).result()
+
+
+if __name__ == "__main__":
+    unittest.main()
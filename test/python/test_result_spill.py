@@ -0,0 +1,40 @@
+import unittest
+
+from ui_server import UIServer
+
+SQL = "SELECT i, i::VARCHAR AS s FROM range(100000) t(i)"
+ROWS = [(i, str(i)) for i in range(100000)]
+
+
+class ResultSpillTest(unittest.TestCase):
+    @classmethod
+    def setUpClass(cls):
+        # The budget is read by the connections of the UI, so it's global.
+        cls.server = UIServer(settings=["SET GLOBAL ui_result_memory_budget = 1048576"])
+
+    @classmethod
+    def tearDownClass(cls):
+        cls.server.close()
+
+    def test_spilled_result(self):
+        response = self.server.run(SQL)
+        # Spilled results are written from the collection as they are read,
+        # so their size isn't known up front.
+        self.assertEqual(response.headers["Transfer-Encoding"], "chunked")
+        self.assertEqual(response.result().rows(), ROWS)
+
+    def test_result_within_budget(self):
+        response = self.server.run("SELECT 42")
+        self.assertIsNone(response.headers["Transfer-Encoding"])
+        self.assertEqual(response.result().rows(), [(42,)])
+
+    def test_spilled_results_are_not_cached(self):
+        cache = {"X-DuckDB-UI-Result-Cache": "true"}
+        for _ in range(2):
+            self.assertEqual(self.server.query(SQL, cache, "cached"), ROWS)
+        (hits,), = self.server.query("SELECT hits FROM ui_result_cache_stats()")
+        self.assertEqual(hits, 0)
+
+
+if __name__ == "__main__":
+    unittest.main()
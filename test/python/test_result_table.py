@@ -0,0 +1,109 @@
+import unittest
+
+from ui_server import QueryError, UIServer, encode_name, wait_until
+
+
+def result_table(name, row_limit):
+    return {
+        "X-DuckDB-UI-Result-Table-Name": encode_name(name),
+        "X-DuckDB-UI-Result-Row-Limit": str(row_limit),
+    }
+
+
+class ResultTableTest(unittest.TestCase):
+    @classmethod
+    def setUpClass(cls):
+        cls.server = UIServer()
+
+    @classmethod
+    def tearDownClass(cls):
+        cls.server.close()
+
+    def count(self, table):
+        rows = self.server.query("SELECT count(*) FROM " + table, connection="check")
+        return rows[0][0]
+
+    def test_filled_after_the_response(self):
+        sql = "SELECT i, i * 2 AS j FROM range(100000) t(i)"
+        rows = self.server.query(sql, result_table("filled", 10), "filling")
+        self.assertEqual(rows, [(i, i * 2) for i in range(10)])
+        wait_until(lambda: self.count("filled") == 100000, "the table is filled")
+        self.assertEqual(
+            self.server.query(
+                "SELECT count(*) FROM filled WHERE j = i * 2", connection="check"
+            ),
+            [(100000,)],
+        )
+
+    def test_new_run_stops_filling(self):
+        sql = "SELECT i FROM range(1000000000) t(i)"
+        self.server.query(sql, result_table("stopped", 10), "stopped")
+        wait_until(lambda: self.count("stopped") > 10, "the table is filling")
+        # A new query on the connection cuts the table short, instead of
+        # waiting for the rest of the rows.
+        self.assertEqual(self.server.query("SELECT 1", connection="stopped"), [(1,)])
+        count = self.count("stopped")
+        self.assertLess(count, 1000000000)
+        self.assertEqual(
+            self.server.query(
+                "SELECT count(*), min(i), max(i) FROM stopped", connection="check"
+            ),
+            [(count, 0, count - 1)],
+        )
+
+    def read(self, table, columns=None, offset=None, limit=None):
+        headers = {"X-DuckDB-UI-Result-Table-Name": encode_name(table)}
+        if columns is not None:
+            headers["X-DuckDB-UI-Result-Columns"] = ",".join(map(str, columns))
+        if offset is not None:
+            headers["X-DuckDB-UI-Result-Row-Offset"] = str(offset)
+        if limit is not None:
+            headers["X-DuckDB-UI-Result-Row-Limit"] = str(limit)
+        return self.server.request("/ddb/read_result_table", headers=headers)
+
+    def test_read_windows(self):
+        sql = "SELECT i, i::VARCHAR AS s, i * 2 AS j FROM range(10000) t(i)"
+        self.server.query(sql, result_table("windows", 10), "windows")
+        wait_until(lambda: self.count("windows") == 10000, "the table is filled")
+
+        result = self.read("windows", columns=[2, 0], offset=5000, limit=3).result()
+        self.assertEqual(result.names, ["j", "i"])
+        self.assertEqual(result.rows(), [(10000, 5000), (10002, 5001), (10004, 5002)])
+
+        rows = self.read("windows", offset=9998).result().rows()
+        self.assertEqual(rows, [(9998, "9998", 19996), (9999, "9999", 19998)])
+
+        self.assertEqual(self.read("windows", offset=20000).result().rows(), [])
+
+    def test_read_while_filling(self):
+        sql = "SELECT i FROM range(1000000000) t(i)"
+        self.server.query(sql, result_table("filling", 10), "filling_read")
+        # Rows are appended in blocks.
+        wait_until(lambda: self.count("filling") > 0, "the table is filling")
+        response = self.read("filling", offset=0, limit=5)
+        self.assertEqual(response.result().rows(), [(i,) for i in range(5)])
+        self.assertEqual(response.headers["X-DuckDB-UI-Result-Table-Complete"], "false")
+        row_count = int(response.headers["X-DuckDB-UI-Result-Table-Row-Count"])
+        self.assertGreater(row_count, 5)
+        self.server.interrupt("filling_read")
+
+        self.server.query("SELECT 42 AS i", result_table("complete", 10), "complete")
+        wait_until(
+            lambda: self.read("complete").headers["X-DuckDB-UI-Result-Table-Complete"]
+            == "true",
+            "the table is complete",
+        )
+        response = self.read("complete")
+        self.assertEqual(response.headers["X-DuckDB-UI-Result-Table-Row-Count"], "1")
+        self.assertEqual(response.result().rows(), [(42,)])
+
+    def test_read_errors(self):
+        with self.assertRaisesRegex(QueryError, "Result table not found"):
+            self.read("missing").result()
+        self.server.query("SELECT 1 AS i", result_table("narrow", 10), "narrow")
+        with self.assertRaisesRegex(QueryError, "out of range"):
+            self.read("narrow", columns=[1]).result()
+
+
+if __name__ == "__main__":
+    unittest.main()
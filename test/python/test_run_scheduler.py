@@ -0,0 +1,143 @@
+import threading
+import unittest
+
+from ui_server import QueryError, UIServer, wait_until
+
+# Runs until interrupted.
+LONG_QUERY = "SELECT sum(i) FROM range(1000000000000) t(i)"
+
+BACKGROUND = {"X-DuckDB-UI-Request-Priority": "background"}
+
+
+class Run(threading.Thread):
+    """Sends a query in the background, and records when it is answered."""
+
+    def __init__(self, server, sql, connection, finished, headers=None):
+        super().__init__(daemon=True)
+        self.server = server
+        self.sql = sql
+        self.connection = connection
+        self.finished = finished
+        self.headers = headers
+        self.response = None
+        self.start()
+
+    def run(self):
+        self.response = self.server.run(self.sql, self.headers, self.connection)
+        self.finished.append(self.connection)
+
+
+class RunSchedulerTest(unittest.TestCase):
+    @classmethod
+    def setUpClass(cls):
+        # One run at a time, with room for two queued runs.
+        cls.server = UIServer(
+            settings=["SET ui_max_concurrent_runs = 1", "SET ui_max_queued_runs = 2"]
+        )
+
+    @classmethod
+    def tearDownClass(cls):
+        cls.server.close()
+
+    def setUp(self):
+        self.finished = []
+
+    def wait_for_stats(self, running, queued):
+        # Read by the CLI: a request of the UI would be queued too.
+        wait_until(
+            lambda: self.server.cli_query(
+                "SELECT running, queued FROM ui_run_scheduler_stats()"
+            )
+            == [[str(running), str(queued)]],
+            "%d runs are running and %d queued" % (running, queued),
+        )
+
+    def start_long_run(self):
+        run = Run(self.server, LONG_QUERY, "long", self.finished)
+        self.wait_for_stats(1, 0)
+        return run
+
+    def stop_long_run(self, run):
+        self.server.interrupt("long")
+        run.join()
+        with self.assertRaisesRegex(QueryError, "nterrupt"):
+            run.response.result()
+
+    def test_rejects_when_full(self):
+        long_run = self.start_long_run()
+        queued = [
+            Run(self.server, "SELECT 1", "queued%d" % i, self.finished)
+            for i in range(2)
+        ]
+        self.wait_for_stats(1, 2)
+
+        response = self.server.run("SELECT 1", connection="rejected")
+        self.assertEqual(response.status, 503)
+        self.assertEqual(response.headers["Retry-After"], "1")
+        with self.assertRaisesRegex(QueryError, "Too many queued requests"):
+            response.result()
+
+        self.stop_long_run(long_run)
+        for run in queued:
+            run.join()
+            self.assertEqual(run.response.result().rows(), [(1,)])
+
+    def test_interactive_runs_first(self):
+        long_run = self.start_long_run()
+        # Slower than the interactive run, so it can't be answered first once
+        # it is admitted.
+        background = Run(
+            self.server,
+            "SELECT count(*) FROM range(10000000)",
+            "background",
+            self.finished,
+            BACKGROUND,
+        )
+        self.wait_for_stats(1, 1)
+        interactive = Run(self.server, "SELECT 2", "interactive", self.finished)
+        self.wait_for_stats(1, 2)
+
+        self.stop_long_run(long_run)
+        background.join()
+        interactive.join()
+        self.assertLess(
+            self.finished.index("interactive"), self.finished.index("background")
+        )
+        self.assertEqual(background.response.result().rows(), [(10000000,)])
+        self.assertEqual(interactive.response.result().rows(), [(2,)])
+
+    def test_interactive_run_displaces_background_run(self):
+        long_run = self.start_long_run()
+        background = [
+            Run(self.server, "SELECT 1", "background%d" % i, self.finished, BACKGROUND)
+            for i in range(2)
+        ]
+        self.wait_for_stats(1, 2)
+        interactive = Run(self.server, "SELECT 2", "interactive", self.finished)
+        # The last background run is rejected right away.
+        wait_until(lambda: len(self.finished) == 1, "a run is displaced")
+        displaced = [run for run in background if run.response is not None]
+        self.assertEqual(len(displaced), 1)
+        self.assertEqual(displaced[0].response.status, 503)
+        with self.assertRaisesRegex(QueryError, "displaced"):
+            displaced[0].response.result()
+
+        self.stop_long_run(long_run)
+        interactive.join()
+        self.assertEqual(interactive.response.result().rows(), [(2,)])
+
+    def test_interrupting_a_queued_run(self):
+        # Only connections that have run a query can be interrupted.
+        self.server.query("SELECT 1", connection="queued")
+        long_run = self.start_long_run()
+        queued = Run(self.server, "SELECT 1", "queued", self.finished)
+        self.wait_for_stats(1, 1)
+        self.server.interrupt("queued")
+        queued.join()
+        with self.assertRaisesRegex(QueryError, "Interrupted"):
+            queued.response.result()
+        self.stop_long_run(long_run)
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,54 @@
+import unittest
+
+from ui_server import QueryError, UIServer
+
+STREAM = {"X-DuckDB-UI-Stream-Result": "true"}
+
+
+class StreamedResultTest(unittest.TestCase):
+    @classmethod
+    def setUpClass(cls):
+        # One thread, so the rows before a failing row are sent before the
+        # query fails.
+        cls.server = UIServer(settings=["SET threads = 1"])
+
+    @classmethod
+    def tearDownClass(cls):
+        cls.server.close()
+
+    def test_frames_hold_the_rows(self):
+        result, error = self.server.run(
+            "SELECT i, i::VARCHAR AS s FROM range(10000) t(i)", STREAM
+        ).stream()
+        self.assertEqual(error, "")
+        self.assertEqual(result.names, ["i", "s"])
+        self.assertGreater(len(result.chunks), 1)
+        self.assertEqual(result.rows(), [(i, str(i)) for i in range(10000)])
+
+    def test_empty_result(self):
+        result, error = self.server.run(
+            "SELECT i FROM range(10) t(i) WHERE i < 0", STREAM
+        ).stream()
+        self.assertEqual(error, "")
+        self.assertEqual(result.names, ["i"])
+        self.assertEqual(result.rows(), [])
+
+    def test_error_ends_the_stream(self):
+        response = self.server.run(
+            "SELECT CASE WHEN i < 1000000 THEN i ELSE error('boom') END AS i "
+            "FROM range(2000000) t(i)",
+            STREAM,
+        )
+        result, error = response.stream()
+        self.assertIn("boom", error)
+        rows = result.rows()
+        self.assertGreater(len(rows), 0)
+        self.assertEqual(rows, [(i,) for i in range(len(rows))])
+
+    def test_error_before_the_first_row(self):
+        with self.assertRaisesRegex(QueryError, "missing_table"):
+            self.server.run("SELECT * FROM missing_table", STREAM).stream()
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,83 @@
+import time
+import unittest
+
+from test_asset_bundle import ASSETS, write_bundle
+from ui_server import RemoteUI, UIServer, wait_until
+
+DOCUMENT = b"""<html>
+<link rel="stylesheet" href="/assets/style.css">
+<script src="./assets/app.js?v=1"></script>
+<script src="https://example.com/other.js"></script>
+<img src="data:image/png;base64,AAAA">
+</html>"""
+IMMUTABLE = {
+    "Cache-Control": "public, max-age=31536000, immutable",
+    "Content-Type": "text/javascript",
+}
+SCRIPT = b"console.log('warm');"
+
+
+class WarmUpTest(unittest.TestCase):
+    def setUp(self):
+        self.remote = RemoteUI()
+        self.remote.put("/", DOCUMENT, {"Content-Type": "text/html"})
+        self.remote.put("/assets/app.js", SCRIPT, IMMUTABLE)
+        self.remote.put("/assets/style.css", b"a {}", {"ETag": '"v1"'})
+        self.server = None
+
+    def tearDown(self):
+        if self.server:
+            self.server.close()
+        self.remote.close()
+
+    def start(self, settings=()):
+        self.server = UIServer(settings=settings, remote=self.remote)
+
+    def test_prefetches_the_referenced_assets(self):
+        self.start()
+        wait_until(
+            lambda: self.remote.get_requests("/assets/app.js")
+            and self.remote.get_requests("/assets/style.css"),
+            "the assets are prefetched",
+        )
+        # Kept in memory, so the page load doesn't fetch it again.
+        self.assertEqual(self.server.get("/assets/app.js").body, SCRIPT)
+        self.assertEqual(len(self.remote.get_requests("/assets/app.js")), 1)
+        # Kept on disk, and revalidated when loaded.
+        self.assertEqual(self.server.get("/assets/style.css").body, b"a {}")
+        self.assertEqual(
+            self.remote.get_requests("/assets/style.css")[-1]["If-None-Match"], '"v1"'
+        )
+        self.assertEqual(len(self.remote.get_requests("/")), 1)
+
+    def test_skipped_with_an_asset_bundle(self):
+        self.start()
+        wait_until(lambda: self.remote.get_requests("/assets/app.js"), "the warm-up")
+        bundle_path = self.server.home + "/bundle-source.tar"
+        write_bundle(bundle_path, ASSETS)
+        self.server.query("SELECT * FROM ui_load_bundle('%s')" % bundle_path)
+        self.server.stop()
+        self.server.start()
+        time.sleep(1)
+        self.assertEqual(len(self.remote.get_requests("/")), 1)
+
+    def test_skipped_with_the_asset_caches_disabled(self):
+        self.start(
+            ["SET ui_asset_cache_size = 0", "SET ui_asset_memory_cache_size = 0"]
+        )
+        time.sleep(1)
+        self.assertEqual(self.remote.get_requests("/"), [])
+
+    def test_stop_cancels_the_fetches(self):
+        # The remote URL accepts the connection, but doesn't answer.
+        self.remote.put("/", DOCUMENT, delay=60)
+        self.start()
+        wait_until(lambda: self.remote.get_requests("/"), "the warm-up")
+        started_at = time.monotonic()
+        self.server.stop()
+        self.server.start()
+        self.assertLess(time.monotonic() - started_at, 10)
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,534 @@
+# Helpers for the tests of the HTTP endpoints of the UI server.
+#
+# Each test module starts a DuckDB CLI built with this extension ($DUCKDB, or
+# build/release/duckdb), and talks to its UI server over HTTP. The CLI gets a
+# temporary home directory, so the asset caches and bundles stay out of the
+# real one, and its remote URL points at a local stand-in for the remote UI,
+# so the tests don't use the network.
+
+import base64
+import http.client
+import http.server
+import json
+import os
+import shutil
+import socket
+import struct
+import subprocess
+import tempfile
+import threading
+import time
+
+ROOT = os.path.abspath(os.path.join(os.path.dirname(__file__), "..", ".."))
+DUCKDB = os.environ.get("DUCKDB", os.path.join(ROOT, "build", "release", "duckdb"))
+
+# Longest a test waits for the server to get somewhere.
+TIMEOUT_S = 30
+
+
+def encode_name(name):
+    """Encodes a name for the headers that take base64."""
+    return base64.b64encode(name.encode()).decode()
+
+
+def wait_until(condition, message, timeout=TIMEOUT_S):
+    """Waits until `condition` returns a true value, and returns it."""
+    deadline = time.monotonic() + timeout
+    while True:
+        value = condition()
+        if value:
+            return value
+        if time.monotonic() > deadline:
+            raise AssertionError("Timed out waiting until " + message)
+        time.sleep(0.05)
+
+
+class RemoteUI:
+    """Stands in for the remote URL the UI assets are fetched from.
+
+    Serves the assets put in it, answers conditional requests for assets with
+    an ETag, and records the requests it gets. Assets can be delayed, to stand
+    in for a remote URL that hangs.
+    """
+
+    def __init__(self):
+        self.assets = {}
+        self.requests = []
+        self.lock = threading.Lock()
+        remote = self
+
+        class Handler(http.server.BaseHTTPRequestHandler):
+            protocol_version = "HTTP/1.1"
+
+            def do_GET(self):
+                path = self.path.split("?")[0]
+                with remote.lock:
+                    remote.requests.append((path, dict(self.headers)))
+                    status, headers, body, delay = remote.assets.get(
+                        path, (404, {}, b"Not found", 0)
+                    )
+                time.sleep(delay)
+                etag = headers.get("ETag")
+                if status == 200 and etag and self.headers.get("If-None-Match") == etag:
+                    status, body = 304, b""
+                self.send_response(status)
+                for name, value in headers.items():
+                    self.send_header(name, value)
+                self.send_header("Content-Length", str(len(body)))
+                self.end_headers()
+                self.wfile.write(body)
+
+            def log_message(self, *args):
+                pass
+
+        self.server = http.server.ThreadingHTTPServer(("127.0.0.1", 0), Handler)
+        self.server.daemon_threads = True
+        self.url = "http://127.0.0.1:%d" % self.server.server_address[1]
+        self.thread = threading.Thread(target=self.server.serve_forever, daemon=True)
+        self.thread.start()
+
+    def put(self, path, body, headers=None, status=200, delay=0):
+        with self.lock:
+            self.assets[path] = (status, dict(headers or {}), body, delay)
+
+    def get_requests(self, path):
+        """Returns the headers of the requests for `path` so far."""
+        with self.lock:
+            return [headers for p, headers in self.requests if p == path]
+
+    def close(self):
+        self.server.shutdown()
+        self.server.server_close()
+
+
+class QueryError(Exception):
+    pass
+
+
+class Response:
+    def __init__(self, status, headers, body):
+        self.status = status
+        self.headers = headers
+        self.body = body
+
+    def result(self):
+        """Decodes a SuccessResult, raising QueryError for an ErrorResult."""
+        deserializer = Deserializer(self.body)
+        result = read_result(deserializer)
+        if not deserializer.at_end():
+            raise ValueError("Trailing bytes after the result")
+        return result
+
+    def stream(self):
+        """Decodes a streamed result: its header, then its frames."""
+        deserializer = Deserializer(self.body)
+        return read_stream(deserializer)
+
+
+class UIServer:
+    """A DuckDB CLI running a UI server.
+
+    `settings` are SQL statements run before the server starts. Settings read
+    by the queries of the UI must be set with SET GLOBAL, because the UI uses
+    its own connections.
+    """
+
+    def __init__(self, settings=(), remote=None, home=None):
+        self.owns_remote = remote is None
+        self.remote = remote or RemoteUI()
+        self.owns_home = home is None
+        self.home = home or tempfile.mkdtemp(prefix="duckdb-ui-test-")
+        # The extension creates its directories in the DuckDB directory.
+        os.makedirs(os.path.join(self.home, ".duckdb"), exist_ok=True)
+        self.port = find_free_port()
+        self.url = "http://localhost:%d" % self.port
+        env = dict(os.environ, HOME=self.home, USERPROFILE=self.home)
+        # The remote URL can only be changed with unsigned extensions allowed.
+        self.cli_query_count = 0
+        self.process = subprocess.Popen(
+            [DUCKDB, "-unsigned"],
+            stdin=subprocess.PIPE,
+            stdout=subprocess.DEVNULL,
+            env=env,
+        )
+        self.execute(
+            "SET ui_local_port = %d" % self.port,
+            "SET ui_remote_url = '%s'" % self.remote.url,
+            *settings
+        )
+        self.start()
+
+    def execute(self, *statements):
+        """Runs statements in the CLI, without waiting for them."""
+        for statement in statements:
+            self.process.stdin.write((statement + ";\n").encode())
+        self.process.stdin.flush()
+
+    def cli_query(self, sql):
+        """Runs a query in the CLI, and returns the fields of its rows as
+        strings. Unlike the queries of the UI, it isn't admitted by the run
+        scheduler. Waits for the result, which must end with a newline."""
+        self.cli_query_count += 1
+        path = os.path.join(self.home, "cli_query_%d.csv" % self.cli_query_count)
+        self.execute("COPY (%s) TO '%s' (HEADER false)" % (sql, path))
+
+        def read():
+            try:
+                with open(path) as f:
+                    content = f.read()
+            except OSError:
+                return None
+            return content if content.endswith("\n") else None
+
+        content = wait_until(read, "the CLI has run: " + sql)
+        return [line.split(",") for line in content.splitlines()]
+
+    def is_up(self):
+        try:
+            return self.request("/info", method="GET").status == 200
+        except OSError:
+            return False
+
+    def start(self):
+        self.execute("CALL start_ui_server()")
+        wait_until(self.is_up, "the UI server is started")
+
+    def stop(self):
+        self.execute("CALL stop_ui_server()")
+        wait_until(lambda: not self.is_up(), "the UI server is stopped")
+
+    def close(self):
+        try:
+            self.process.stdin.close()
+            self.process.wait(TIMEOUT_S)
+        except (OSError, subprocess.TimeoutExpired):
+            self.process.kill()
+            self.process.wait()
+        if self.owns_remote:
+            self.remote.close()
+        if self.owns_home:
+            shutil.rmtree(self.home, ignore_errors=True)
+
+    def request(self, path, body=b"", headers=None, method="POST"):
+        connection = http.client.HTTPConnection(
+            "localhost", self.port, timeout=TIMEOUT_S
+        )
+        try:
+            all_headers = {"Origin": self.url, "Accept-Encoding": "identity"}
+            all_headers.update(headers or {})
+            connection.request(method, path, body=body, headers=all_headers)
+            response = connection.getresponse()
+            return Response(response.status, response.headers, response.read())
+        finally:
+            connection.close()
+
+    def get(self, path, headers=None):
+        return self.request(path, headers=headers, method="GET")
+
+    def run(self, sql, headers=None, connection=None):
+        """Sends a query to /ddb/run."""
+        all_headers = dict(headers or {})
+        if connection:
+            all_headers["X-DuckDB-UI-Connection-Name"] = connection
+        return self.request("/ddb/run", sql.encode(), all_headers)
+
+    def query(self, sql, headers=None, connection=None):
+        """Runs a query, and returns the rows of its result."""
+        return self.run(sql, headers, connection).result().rows()
+
+    def interrupt(self, connection):
+        self.request(
+            "/ddb/interrupt", headers={"X-DuckDB-UI-Connection-Name": connection}
+        )
+
+
+def find_free_port():
+    with socket.socket() as s:
+        s.bind(("localhost", 0))
+        return s.getsockname()[1]
+
+
+class EventStream:
+    """Collects the server-sent events of /localEvents in the background."""
+
+    def __init__(self, server):
+        self.events = []
+        self.condition = threading.Condition()
+        self.connection = http.client.HTTPConnection(
+            "localhost", server.port, timeout=TIMEOUT_S
+        )
+        self.connection.request("GET", "/localEvents")
+        self.response = self.connection.getresponse()
+        self.thread = threading.Thread(target=self.read, daemon=True)
+        self.thread.start()
+
+    def read(self):
+        buffer = ""
+        try:
+            while True:
+                data = self.response.read1(4096)
+                if not data:
+                    return
+                # Keep-alive messages end their lines with \r.
+                buffer += data.decode().replace("\r\n", "\n").replace("\r", "\n")
+                while "\n\n" in buffer:
+                    message, buffer = buffer.split("\n\n", 1)
+                    self.add(message)
+        except (OSError, ValueError):
+            pass
+
+    def add(self, message):
+        name = None
+        data = ""
+        for line in message.split("\n"):
+            if line.startswith("event: "):
+                name = line[len("event: "):]
+            elif line.startswith("data:"):
+                data = line[len("data:"):].strip()
+        if name is None:
+            return
+        try:
+            data = json.loads(data) if data else None
+        except ValueError:
+            pass
+        with self.condition:
+            self.events.append((name, data))
+            self.condition.notify_all()
+
+    def wait_for(self, name, predicate=lambda data: True, timeout=TIMEOUT_S):
+        """Waits for an event named `name` whose data matches, and returns its
+        data."""
+        deadline = time.monotonic() + timeout
+        with self.condition:
+            while True:
+                for event_name, data in self.events:
+                    if event_name == name and predicate(data):
+                        return data
+                remaining = deadline - time.monotonic()
+                if remaining <= 0:
+                    raise AssertionError("Timed out waiting for " + name)
+                self.condition.wait(remaining)
+
+    def close(self):
+        try:
+            self.connection.sock.shutdown(socket.SHUT_RDWR)
+        except OSError:
+            pass
+        self.connection.close()
+
+
+# Decoding of the binary results. See utils/serialization.hpp, and DuckDB's
+# BinarySerializer and Vector::Serialize. Supports the types the tests use.
+
+OBJECT_END = 0xFFFF
+
+# Struct formats of the fixed-size types, by LogicalTypeId.
+FIXED_SIZE_FORMATS = {
+    10: "?",  # BOOLEAN
+    11: "b",  # TINYINT
+    12: "h",  # SMALLINT
+    13: "i",  # INTEGER
+    14: "q",  # BIGINT
+    15: "i",  # DATE, as days since the epoch
+    22: "f",  # FLOAT
+    23: "d",  # DOUBLE
+    28: "B",  # UTINYINT
+    29: "H",  # USMALLINT
+    30: "I",  # UINTEGER
+    31: "Q",  # UBIGINT
+}
+VARCHAR = 25
+
+FLAT_VECTOR = 0
+CONSTANT_VECTOR = 2
+DICTIONARY_VECTOR = 3
+SEQUENCE_VECTOR = 4
+
+
+class Deserializer:
+    def __init__(self, data):
+        self.data = data
+        self.offset = 0
+
+    def at_end(self):
+        return self.offset >= len(self.data)
+
+    def peek_field(self):
+        return struct.unpack_from("<H", self.data, self.offset)[0]
+
+    def field(self, field_id):
+        actual = self.peek_field()
+        if actual != field_id:
+            raise ValueError(
+                "Expected field %d, got %d at offset %d"
+                % (field_id, actual, self.offset)
+            )
+        self.offset += 2
+
+    def optional_field(self, field_id):
+        if not self.at_end() and self.peek_field() == field_id:
+            self.offset += 2
+            return True
+        return False
+
+    def end(self):
+        self.field(OBJECT_END)
+
+    def uint8(self):
+        value = self.data[self.offset]
+        self.offset += 1
+        return value
+
+    def varint(self):
+        value = 0
+        shift = 0
+        while True:
+            byte = self.uint8()
+            value |= (byte & 0x7F) << shift
+            shift += 7
+            if not byte & 0x80:
+                return value
+
+    def bytes(self):
+        size = self.varint()
+        value = self.data[self.offset:self.offset + size]
+        self.offset += size
+        return value
+
+    def string(self):
+        return self.bytes().decode()
+
+    def list(self, read):
+        return [read(i) for i in range(self.varint())]
+
+
+class Result:
+    def __init__(self, names, types, chunks, cursor_id=""):
+        self.names = names
+        self.types = types
+        # Pairs of a row count and a list of column values.
+        self.chunks = chunks
+        self.cursor_id = cursor_id
+
+    def rows(self):
+        rows = []
+        for row_count, columns in self.chunks:
+            rows.extend(
+                tuple(column[i] for column in columns) for i in range(row_count)
+            )
+        return rows
+
+
+def read_type(d):
+    d.field(100)
+    type_id = d.uint8()
+    if d.optional_field(101) and d.uint8():
+        raise ValueError("Types with type info are not supported")
+    d.end()
+    return type_id
+
+
+def read_columns(d):
+    d.field(100)
+    names = d.list(lambda i: d.string())
+    d.field(101)
+    types = d.list(lambda i: read_type(d))
+    d.end()
+    return names, types
+
+
+def read_flat_vector(d, type_id):
+    d.field(100)
+    validity = None
+    if d.uint8():
+        d.field(101)
+        validity = d.bytes()
+    d.field(102)
+    if type_id == VARCHAR:
+        values = d.list(lambda i: d.string())
+    elif type_id in FIXED_SIZE_FORMATS:
+        value_format = "<" + FIXED_SIZE_FORMATS[type_id]
+        values = [value for (value,) in struct.iter_unpack(value_format, d.bytes())]
+    else:
+        raise ValueError("Unsupported type id %d" % type_id)
+    d.end()
+    if validity is not None:
+        values = [
+            value if validity[i // 8] >> (i % 8) & 1 else None
+            for i, value in enumerate(values)
+        ]
+    return values
+
+
+def read_vector(d, type_id, row_count):
+    vector_type = d.uint8() if d.optional_field(90) else FLAT_VECTOR
+    if vector_type == FLAT_VECTOR:
+        return read_flat_vector(d, type_id)
+    if vector_type == CONSTANT_VECTOR:
+        return read_flat_vector(d, type_id) * row_count
+    if vector_type == DICTIONARY_VECTOR:
+        d.field(91)
+        positions = struct.unpack("<%dI" % row_count, d.bytes())
+        entries = read_flat_vector(d, type_id)
+        return [entries[position] for position in positions]
+    if vector_type == SEQUENCE_VECTOR:
+        d.field(92)
+        start, increment = struct.unpack("<qq", d.bytes())
+        d.end()
+        return [start + i * increment for i in range(row_count)]
+    raise ValueError("Unsupported vector type %d" % vector_type)
+
+
+def read_chunk(d, types):
+    d.field(100)
+    row_count = d.varint()
+    d.field(101)
+    columns = d.list(lambda i: read_vector(d, types[i], row_count))
+    d.end()
+    return row_count, columns
+
+
+def read_error(d):
+    d.field(101)
+    error = d.string()
+    d.end()
+    return QueryError(error)
+
+
+def read_result(d):
+    d.field(100)
+    if not d.uint8():
+        raise read_error(d)
+    d.field(101)
+    names, types = read_columns(d)
+    d.field(102)
+    chunks = d.list(lambda i: read_chunk(d, types))
+    cursor_id = d.string() if d.optional_field(103) else ""
+    d.end()
+    return Result(names, types, chunks, cursor_id)
+
+
+def read_stream(d):
+    """Returns the result holding the chunks of the frames, and the error of
+    the end frame, if any."""
+    d.field(100)
+    if not d.uint8():
+        raise read_error(d)
+    d.field(101)
+    names, types = read_columns(d)
+    d.end()
+    chunks = []
+    while True:
+        d.field(100)
+        done = d.uint8()
+        if done:
+            d.field(101)
+            error = d.string()
+            d.end()
+            break
+        d.field(102)
+        chunks.append(read_chunk(d, types))
+        d.end()
+    if not d.at_end():
+        raise ValueError("Bytes after the end frame")
+    return Result(names, types, chunks), error
@@ -1,6 +1,7 @@
 import { DuckDBUIHttpRequestQueue } from '../../http/classes/DuckDBUIHttpRequestQueue.js';
 import { makeDuckDBUIHttpRequestHeaders } from '../../http/functions/makeDuckDBUIHttpRequestHeaders.js';
 import { sendDuckDBUIHttpRequest } from '../../http/functions/sendDuckDBUIHttpRequest.js';
+import { SERIALIZATION_VERSION } from '../../serialization/constants/SerializationVersion.js';
 import { randomString } from '../../util/functions/randomString.js';
 import { materializedRunResultFromQueueResult } from '../functions/materializedRunResultFromQueueResult.js';
 import { DuckDBUIRunOptions } from '../types/DuckDBUIRunOptions.js';
@@ -63,6 +64,7 @@ export class DuckDBUIClientConnection {
     return makeDuckDBUIHttpRequestHeaders({
       ...options,
       connectionName: this.connectionName,
+      serializationVersion: SERIALIZATION_VERSION,
     });
   }
 }
@@ -5,6 +5,7 @@ export interface DuckDBUIRunOptions {
   errorsAsJson?: boolean;
   parameters?: unknown[];
   resultRowLimit?: number;
+  resultBatchSize?: number;
   resultDatabaseName?: string;
   resultSchemaName?: string;
   resultTableName?: string;
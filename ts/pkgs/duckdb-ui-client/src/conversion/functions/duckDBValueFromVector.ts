@@ -61,6 +61,22 @@ export function duckDBValueFromVector(
   vector: Vector,
   rowIndex: number,
 ): DuckDBValue {
+  // Compressed vectors are expanded one value at a time, as they are read.
+  switch (vector.kind) {
+    case 'constant':
+      return duckDBValueFromVector(typeIdAndInfo, vector.child, 0);
+    case 'dictionary':
+      return duckDBValueFromVector(
+        typeIdAndInfo,
+        vector.dictionary,
+        getUInt32(vector.selection, rowIndex * 4),
+      );
+    case 'sequence': {
+      const value = vector.start + vector.increment * BigInt(rowIndex);
+      return typeIdAndInfo.id === LogicalTypeId.BIGINT ? value : Number(value);
+    }
+  }
+
   if (!isRowValid(vector.validity, rowIndex)) return null;
 
   const { id, typeInfo } = typeIdAndInfo;
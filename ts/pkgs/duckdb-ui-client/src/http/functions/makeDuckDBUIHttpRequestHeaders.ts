@@ -3,6 +3,7 @@ import { toBase64 } from '../../util/functions/toBase64.js';
 
 export interface DuckDBUIHttpRequestHeaderOptions extends DuckDBUIRunOptions {
   connectionName?: string;
+  serializationVersion?: number;
 }
 
 export function makeDuckDBUIHttpRequestHeaders({
@@ -13,10 +14,12 @@ export function makeDuckDBUIHttpRequestHeaders({
   errorsAsJson,
   parameters,
   resultRowLimit,
+  resultBatchSize,
   resultDatabaseName,
   resultSchemaName,
   resultTableName,
   resultTableRowLimit,
+  serializationVersion,
 }: DuckDBUIHttpRequestHeaderOptions): Headers {
   const headers = new Headers();
   // We base64 encode some values because they can contain characters invalid in an HTTP header.
@@ -45,6 +48,9 @@ export function makeDuckDBUIHttpRequestHeaders({
   if (resultRowLimit !== undefined) {
     headers.append('X-DuckDB-UI-Result-Row-Limit', String(resultRowLimit));
   }
+  if (resultBatchSize !== undefined) {
+    headers.append('X-DuckDB-UI-Result-Batch-Size', String(resultBatchSize));
+  }
   if (resultDatabaseName) {
     headers.append(
       'X-DuckDB-UI-Result-Database-Name',
@@ -69,5 +75,11 @@ export function makeDuckDBUIHttpRequestHeaders({
   if (errorsAsJson) {
     headers.append('X-DuckDB-UI-Errors-As-JSON', 'true');
   }
+  if (serializationVersion !== undefined) {
+    headers.append(
+      'X-DuckDB-UI-Serialization-Version',
+      String(serializationVersion),
+    );
+  }
   return headers;
 }
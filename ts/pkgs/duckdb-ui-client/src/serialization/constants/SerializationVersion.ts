@@ -0,0 +1,11 @@
+/**
+ * Latest version of the result serialization this client can read. Sent to the
+ * server in the X-DuckDB-UI-Serialization-Version header.
+ *
+ * Version 2 keeps constant, dictionary and sequence vectors compressed. Servers
+ * that don't support it send version 1, which this client also reads.
+ *
+ * Version 3 allows chunks with more than 2048 rows, so results arrive in fewer,
+ * larger batches.
+ */
+export const SERIALIZATION_VERSION = 3;
@@ -0,0 +1,12 @@
+/**
+ * The subset of DuckDB's VectorType sent by the server when serialization
+ * version 2 is requested. Other vectors are sent flattened.
+ *
+ * See VectorType in https://github.com/duckdb/duckdb/blob/main/src/include/duckdb/common/enums/vector_type.hpp
+ */
+export const VectorType = {
+  FLAT_VECTOR: 0,
+  CONSTANT_VECTOR: 2,
+  DICTIONARY_VECTOR: 3,
+  SEQUENCE_VECTOR: 4,
+};
@@ -1,5 +1,6 @@
 import { BinaryDeserializer } from '../classes/BinaryDeserializer.js';
 import { LogicalTypeId } from '../constants/LogicalTypeId.js';
+import { VectorType } from '../constants/VectorType.js';
 import { TypeIdAndInfo } from '../types/TypeInfo.js';
 import { BaseVector, ListEntry, Vector } from '../types/Vector.js';
 import {
@@ -24,10 +25,53 @@ export function readListEntryList(
   return readList(deserializer, readListEntry);
 }
 
-/** See Vector::Deserialize in https://github.com/duckdb/duckdb/blob/main/src/common/types/vector.cpp */
+/**
+ * Reads a vector of serialization version 2 (or 1). Compressed vectors start
+ * with their vector type, and are expanded lazily, when their values are read.
+ */
 export function readVector(
   deserializer: BinaryDeserializer,
   type: TypeIdAndInfo,
+): Vector {
+  const vectorType = deserializer.readPropertyWithDefault(
+    90,
+    readUint8,
+    VectorType.FLAT_VECTOR,
+  );
+  const noValidity: BaseVector = { allValid: 0, validity: null };
+  switch (vectorType) {
+    case VectorType.FLAT_VECTOR:
+      return readFlatVector(deserializer, type);
+    case VectorType.CONSTANT_VECTOR:
+      return {
+        ...noValidity,
+        kind: 'constant',
+        child: readFlatVector(deserializer, type),
+      };
+    case VectorType.DICTIONARY_VECTOR: {
+      const selection = deserializer.readProperty(91, readData);
+      const dictionary = readFlatVector(deserializer, type);
+      return { ...noValidity, kind: 'dictionary', selection, dictionary };
+    }
+    case VectorType.SEQUENCE_VECTOR: {
+      const sequence = deserializer.readProperty(92, readData);
+      deserializer.expectObjectEnd();
+      return {
+        ...noValidity,
+        kind: 'sequence',
+        start: sequence.getBigInt64(0, true),
+        increment: sequence.getBigInt64(8, true),
+      };
+    }
+    default:
+      throw new Error(`unrecognized vector type: ${vectorType}`);
+  }
+}
+
+/** See Vector::Deserialize in https://github.com/duckdb/duckdb/blob/main/src/common/types/vector.cpp */
+export function readFlatVector(
+  deserializer: BinaryDeserializer,
+  type: TypeIdAndInfo,
 ): Vector {
   const allValid = deserializer.readProperty(100, readUint8);
   const validity = allValid ? deserializer.readProperty(101, readData) : null;
@@ -41,6 +41,29 @@ export interface ArrayVector extends BaseVector {
   child: Vector;
 }
 
+/** A single value for all rows. The validity of the value is in the child. */
+export interface ConstantVector extends BaseVector {
+  kind: 'constant';
+  child: Vector;
+}
+
+/**
+ * Rows refer to entries of a dictionary, by the uint32 positions in
+ * `selection`. The validity of each entry is in the dictionary.
+ */
+export interface DictionaryVector extends BaseVector {
+  kind: 'dictionary';
+  selection: DataView;
+  dictionary: Vector;
+}
+
+/** Integers starting at `start`, increasing by `increment` for each row. */
+export interface SequenceVector extends BaseVector {
+  kind: 'sequence';
+  start: bigint;
+  increment: bigint;
+}
+
 /** See https://github.com/duckdb/duckdb/blob/main/src/include/duckdb/common/types/vector.hpp */
 export type Vector =
   | DataVector
@@ -48,4 +71,7 @@ export type Vector =
   | DataListVector
   | VectorListVector
   | ListVector
-  | ArrayVector;
+  | ArrayVector
+  | ConstantVector
+  | DictionaryVector
+  | SequenceVector;
@@ -24,6 +24,20 @@ suite('makeDuckDBUIHttpRequestHeaders', () => {
       }).entries(),
     ]).toEqual([['x-duckdb-ui-database-name', 'ZXhhbXBsZSBkYXRhYmFzZSBuYW1l']]);
   });
+  test('serialization version', () => {
+    expect([
+      ...makeDuckDBUIHttpRequestHeaders({
+        serializationVersion: 2,
+      }).entries(),
+    ]).toEqual([['x-duckdb-ui-serialization-version', '2']]);
+  });
+  test('result batch size', () => {
+    expect([
+      ...makeDuckDBUIHttpRequestHeaders({
+        resultBatchSize: 65536,
+      }).entries(),
+    ]).toEqual([['x-duckdb-ui-result-batch-size', '65536']]);
+  });
   test('parameters', () => {
     // values should be base64 encoded
     expect([
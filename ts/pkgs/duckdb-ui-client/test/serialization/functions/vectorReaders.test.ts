@@ -0,0 +1,89 @@
+import { expect, suite, test } from 'vitest';
+import { duckDBValueFromVector } from '../../../src/conversion/functions/duckDBValueFromVector';
+import { BinaryDeserializer } from '../../../src/serialization/classes/BinaryDeserializer';
+import { BinaryStreamReader } from '../../../src/serialization/classes/BinaryStreamReader';
+import { LogicalTypeId } from '../../../src/serialization/constants/LogicalTypeId';
+import { readVector } from '../../../src/serialization/functions/vectorReaders';
+import { makeBuffer } from '../../helpers/makeBuffer';
+
+const INTEGER = { id: LogicalTypeId.INTEGER };
+const BIGINT = { id: LogicalTypeId.BIGINT };
+const VARCHAR = { id: LogicalTypeId.VARCHAR };
+
+function makeDeserializer(bytes: number[]) {
+  return new BinaryDeserializer(new BinaryStreamReader(makeBuffer(bytes)));
+}
+
+suite('readVector', () => {
+  test('flat', () => {
+    const vector = readVector(
+      makeDeserializer([
+        // has validity mask: false
+        100, 0, 0,
+        // data: 7, 9
+        102, 0, 8, 7, 0, 0, 0, 9, 0, 0, 0,
+        // end
+        0xff, 0xff,
+      ]),
+      INTEGER,
+    );
+    expect(vector.kind).toBe('data');
+    expect(duckDBValueFromVector(INTEGER, vector, 0)).toBe(7);
+    expect(duckDBValueFromVector(INTEGER, vector, 1)).toBe(9);
+  });
+  test('constant', () => {
+    const vector = readVector(
+      makeDeserializer([
+        // vector type: CONSTANT_VECTOR
+        90, 0, 2,
+        // has validity mask: false
+        100, 0, 0,
+        // data: ['duck']
+        102, 0, 1, 4, 0x64, 0x75, 0x63, 0x6b,
+        // end
+        0xff, 0xff,
+      ]),
+      VARCHAR,
+    );
+    expect(vector.kind).toBe('constant');
+    expect(duckDBValueFromVector(VARCHAR, vector, 0)).toBe('duck');
+    expect(duckDBValueFromVector(VARCHAR, vector, 1000)).toBe('duck');
+  });
+  test('dictionary', () => {
+    const vector = readVector(
+      makeDeserializer([
+        // vector type: DICTIONARY_VECTOR
+        90, 0, 3,
+        // selection: 1, 0, 1
+        91, 0, 12, 1, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0,
+        // has validity mask: false
+        100, 0, 0,
+        // data: ['walk', 'fly']
+        102, 0, 2, 4, 0x77, 0x61, 0x6c, 0x6b, 3, 0x66, 0x6c, 0x79,
+        // end
+        0xff, 0xff,
+      ]),
+      VARCHAR,
+    );
+    expect(vector.kind).toBe('dictionary');
+    expect(duckDBValueFromVector(VARCHAR, vector, 0)).toBe('fly');
+    expect(duckDBValueFromVector(VARCHAR, vector, 1)).toBe('walk');
+    expect(duckDBValueFromVector(VARCHAR, vector, 2)).toBe('fly');
+  });
+  test('sequence', () => {
+    const bytes = [
+      // vector type: SEQUENCE_VECTOR
+      90, 0, 4,
+      // sequence: start 10, increment 3
+      92, 0, 16, 10, 0, 0, 0, 0, 0, 0, 0, 3, 0, 0, 0, 0, 0, 0, 0,
+      // end
+      0xff, 0xff,
+    ];
+    const vector = readVector(makeDeserializer(bytes), INTEGER);
+    expect(vector.kind).toBe('sequence');
+    expect(duckDBValueFromVector(INTEGER, vector, 0)).toBe(10);
+    expect(duckDBValueFromVector(INTEGER, vector, 2)).toBe(16);
+    const bigintVector = readVector(makeDeserializer(bytes), BIGINT);
+    expect(duckDBValueFromVector(BIGINT, bigintVector, 1)).toBe(13n);
+  });
+});